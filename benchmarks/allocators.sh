@@ -0,0 +1,37 @@
+#!/bin/bash
+# Register allocators compared by the benchmarks, as "name|llc flags".
+BENCH_DIR=$(dirname "$(readlink -f "${BASH_SOURCE[0]}")")
+SRC_DIR=$(readlink -f "$BENCH_DIR/../src")
+
+ALLOCATORS=(
+	"llvm-fast|-regalloc=fast"
+	"llvm-pbqp|-regalloc=pbqp"
+	"llvm-greedy|-regalloc=greedy"
+	"llvm-basic|-regalloc=basic"
+	"oidara|-load $SRC_DIR/color-based/libRegAllocColor.so -regalloc=colorBased-oidara"
+	"ours|-load $SRC_DIR/color-based/libRegAllocColor.so -regalloc=colorBased-ours"
+	"ours-loop|-load $SRC_DIR/color-based/libRegAllocColor.so -regalloc=colorBased-ours -color-select-order=loop"
+	"ours-freq|-load $SRC_DIR/color-based/libRegAllocColor.so -regalloc=colorBased-ours -color-select-order=freq"
+	"ours-pbqp|-load $SRC_DIR/color-based/libRegAllocColor.so -regalloc=colorBased-pbqp"
+)
+
+# allocator_flags NAME - print the llc flags of allocator NAME.
+function allocator_flags() {
+	local entry
+	for entry in "${ALLOCATORS[@]}"; do
+		if [ "${entry%%|*}" == "$1" ]; then
+			echo "${entry#*|}"
+			return 0
+		fi
+	done
+	echo "Unknown allocator: $1" >&2
+	return 1
+}
+
+# allocator_names - print the name of every allocator, one per line.
+function allocator_names() {
+	local entry
+	for entry in "${ALLOCATORS[@]}"; do
+		echo "${entry%%|*}"
+	done
+}
@@ -1,6 +1,8 @@
 #!/bin/bash
 set -e
 
+source allocators.sh
+
 function build_tinycc {
 	echo "Building tinycc with register allocator $1 (flags: $2)..."
 	cd tinycc
@@ -18,9 +20,6 @@ function build_tinycc {
 
 rm -rf build
 mkdir build
-build_tinycc "llvm-fast" "-regalloc=fast"
-build_tinycc "llvm-pbqp" "-regalloc=pbqp"
-build_tinycc "llvm-greedy" "-regalloc=greedy"
-build_tinycc "llvm-basic" "-regalloc=basic"
-build_tinycc "oidara" "-load ../../src/oidara-algorithm/libRegAllocColor.so -regalloc=colorBased"
-build_tinycc "ours" "-load ../../src/our-algorithm/libRegAllocColor.so -regalloc=colorBased"
+for name in $(allocator_names); do
+	build_tinycc "$name" "$(allocator_flags "$name")"
+done
@@ -0,0 +1,69 @@
+#!/bin/bash
+# Regression gate: compare a run of run-benchmark.sh (JSON format) against the
+# checked-in baseline and exit non-zero when ours/oidara got significantly
+# worse on some metric and translation unit. Reference allocators are used to
+# cancel out machine and LLVM drift, see compare.awk.
+#
+# To record a new baseline, run the benchmarks on the benchmark machine with
+# all allocators and pass -u:
+#   ./run-benchmark.sh -m cc-time,bin-size,tcc-time
+#   ./compare-baseline.sh -u results/benchmark.json
+set -e
+
+cd "$(dirname "$(readlink -f "$0")")"
+
+BASELINE="baseline/benchmark.json"
+CHECKED="ours,oidara"
+REFS="llvm-greedy,llvm-basic,llvm-fast,llvm-pbqp"
+THRESHOLD=5
+ALPHA=0.01
+UPDATE=0
+
+function usage() {
+	cat <<EOF
+Usage: $0 [options] [RESULTS]
+  -b FILE       baseline file ($BASELINE)
+  -c ALLOCS     allocators checked for regressions ($CHECKED)
+  -r ALLOCS     reference allocators used to normalize drift ($REFS)
+  -t PERCENT    regression threshold on the median ($THRESHOLD)
+  -p ALPHA      significance level of the Mann-Whitney test ($ALPHA)
+  -u            replace the baseline with RESULTS instead of comparing
+RESULTS defaults to results/benchmark.json.
+EOF
+	exit "$1"
+}
+
+while getopts "b:c:r:t:p:uh" opt; do
+	case "$opt" in
+	b) BASELINE="$OPTARG" ;;
+	c) CHECKED="$OPTARG" ;;
+	r) REFS="$OPTARG" ;;
+	t) THRESHOLD="$OPTARG" ;;
+	p) ALPHA="$OPTARG" ;;
+	u) UPDATE=1 ;;
+	h) usage 0 ;;
+	*) usage 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+RESULTS="${1:-results/benchmark.json}"
+
+if [ ! -f "$RESULTS" ]; then
+	echo "No results at $RESULTS, run ./run-benchmark.sh first" >&2
+	exit 2
+fi
+
+if [ "$UPDATE" -eq 1 ]; then
+	mkdir -p "$(dirname "$BASELINE")"
+	cp "$RESULTS" "$BASELINE"
+	echo "Baseline updated: $BASELINE"
+	exit 0
+fi
+
+if [ ! -f "$BASELINE" ]; then
+	echo "No baseline at $BASELINE, record one with -u" >&2
+	exit 2
+fi
+
+awk -v checked="$CHECKED" -v refs="$REFS" -v threshold="$THRESHOLD" \
+	-v alpha="$ALPHA" -f stats.awk -f compare.awk "$BASELINE" "$RESULTS"
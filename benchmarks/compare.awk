@@ -0,0 +1,126 @@
+# Compare benchmark results against a stored baseline.
+#
+# Both files are JSON written by summarize.awk (one record per line). The
+# first file is the baseline, the second one the current run. For every
+# (metric, tu) the reference allocators give a drift factor: the geometric
+# mean of their current/baseline median ratios. Baseline samples of each
+# checked allocator are scaled by it, so a slower machine or a different
+# LLVM build does not show up as a regression. A regression is reported when
+# the scaled median grew by more than `threshold` percent and, for metrics
+# with more than one sample, a Mann-Whitney test gives p < alpha.
+#
+# Usage: awk -v checked=ours,oidara -v refs=llvm-greedy,... -v threshold=5 \
+#            -v alpha=0.01 -f stats.awk -f compare.awk baseline.json current.json
+# Exits with status 1 when at least one regression was found.
+
+BEGIN {
+	if (checked == "")
+		checked = "ours,oidara"
+	if (refs == "")
+		refs = "llvm-greedy,llvm-basic,llvm-fast,llvm-pbqp"
+	if (threshold == "")
+		threshold = 5
+	if (alpha == "")
+		alpha = 0.01
+	nchecked = split(checked, checked_list, ",")
+	nrefs = split(refs, ref_list, ",")
+}
+
+# field(name) - value of "name" in the current record line.
+function field(name,    s) {
+	if (!match($0, "\"" name "\": (\"[^\"]*\"|[^,}]*)"))
+		return ""
+	s = substr($0, RSTART + length(name) + 4, RLENGTH - length(name) - 4)
+	gsub(/"/, "", s)
+	return s
+}
+
+FNR == 1 {
+	run = ++nfiles == 1 ? "base" : "cur"
+}
+
+/"median":/ {
+	key = field("metric") SUBSEP field("tu")
+	alloc = field("allocator")
+	med[run, key, alloc] = field("median")
+	s = $0
+	sub(/.*"samples": \[/, "", s)
+	sub(/\].*/, "", s)
+	n = split(s, values, ", ")
+	count[run, key, alloc] = n
+	for (i = 1; i <= n; i++)
+		sample[run, key, alloc, i] = values[i]
+	if (run == "cur" && !(key in seen_key)) {
+		seen_key[key] = 1
+		keys[++nkeys] = key
+	}
+}
+
+# drift(key) - geometric mean of the current/baseline ratio of the reference
+# allocators measured in both runs, 1 when there is none.
+function drift(key,    i, r, logsum, n) {
+	logsum = 0
+	n = 0
+	for (i = 1; i <= nrefs; i++) {
+		r = ref_list[i]
+		if (!(("base", key, r) in med) || !(("cur", key, r) in med))
+			continue
+		if (med["base", key, r] <= 0 || med["cur", key, r] <= 0)
+			continue
+		logsum += log(med["cur", key, r] / med["base", key, r])
+		n++
+	}
+	return n ? exp(logsum / n) : 1
+}
+
+END {
+	printf "%-8s %-20s %-8s %12s %12s %8s %10s  %s\n", "metric", "tu",
+	       "alloc", "baseline", "current", "change", "p", "status"
+	regressions = 0
+	for (k = 1; k <= nkeys; k++) {
+		key = keys[k]
+		split(key, parts, SUBSEP)
+		f = drift(key)
+		for (c = 1; c <= nchecked; c++) {
+			alloc = checked_list[c]
+			if (!(("cur", key, alloc) in med))
+				continue
+			if (!(("base", key, alloc) in med)) {
+				printf "%-8s %-20s %-8s %12s %12s %8s %10s  %s\n", parts[1],
+				       parts[2], alloc, "-", med["cur", key, alloc], "-", "-",
+				       "new"
+				continue
+			}
+			nb = count["base", key, alloc]
+			nc = count["cur", key, alloc]
+			for (i = 1; i <= nb; i++)
+				b[i] = sample["base", key, alloc, i] * f
+			for (i = 1; i <= nc; i++)
+				a[i] = sample["cur", key, alloc, i]
+			bmed = median(b, nb)
+			cmed = median(a, nc)
+			change = bmed > 0 ? (cmed - bmed) / bmed * 100 : 0
+			p = "-"
+			significant = 1
+			if (nb > 1 && nc > 1) {
+				mann_whitney(a, nc, b, nb, res)
+				p = sprintf("%.3g", res["p"])
+				significant = res["p"] < alpha
+			}
+			status = "ok"
+			if (change > threshold && significant) {
+				status = "REGRESSION"
+				regressions++
+			} else if (change < -threshold && significant) {
+				status = "improved"
+			}
+			printf "%-8s %-20s %-8s %12.6g %12.6g %+7.2f%% %10s  %s\n",
+			       parts[1], parts[2], alloc, bmed, cmed, change, p, status
+		}
+	}
+	if (regressions) {
+		printf "%d regression(s) above %s%% (alpha %s)\n", regressions,
+		       threshold, alpha
+		exit 1
+	}
+}
@@ -0,0 +1,237 @@
+//===-- RegAllocTimer.cpp - In-process register allocator timing tool ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This tool parses a bitcode file once and then runs the llc code generation
+// pipeline N times on fresh clones of the module, reporting the time spent in
+// the register allocator for every iteration. Unlike timing llc runs from the
+// shell, process startup, bitcode parsing and option handling are paid only
+// once, so the noise of the measurement is in the microseconds.
+//
+// Allocator plugins are loaded with -load, exactly like llc:
+//   regalloc-timer -load libRegAllocColor.so -regalloc=colorBased-ours -n 20 x.bc
+// With -allocators, every iteration runs each of the listed allocators in
+// turn on the same parsed module, for A/B comparisons in one process:
+//   regalloc-timer -load libRegAllocColor.so \
+//                  -allocators=colorBased-ours,colorBased-oidara,greedy x.bc
+//
+// Output is one "iteration,allocator,regalloc_seconds,codegen_seconds" line
+// per timed iteration and allocator. Warm-up iterations (-warmup) are run but
+// not printed.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/CodeGen/CommandFlags.h"
+#include "llvm/CodeGen/LinkAllAsmWriterComponents.h"
+#include "llvm/CodeGen/LinkAllCodegenComponents.h"
+#include "llvm/CodeGen/RegAllocRegistry.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PluginLoader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::opt<std::string>
+InputFilename(cl::Positional, cl::desc("<input bitcode>"), cl::Required);
+
+static cl::opt<unsigned>
+Iterations("n", cl::desc("Number of timed code generation runs"),
+           cl::init(20));
+
+static cl::opt<unsigned>
+Warmups("warmup", cl::desc("Number of untimed code generation runs"),
+        cl::init(2));
+
+static cl::opt<char>
+OptLevel("O", cl::desc("Optimization level. [-O0, -O1, -O2, or -O3] "
+                       "(default = '-O2')"),
+         cl::Prefix, cl::ZeroOrMore, cl::init(' '));
+
+static cl::list<std::string>
+Allocators("allocators", cl::CommaSeparated,
+           cl::desc("Register allocators run in turn on every iteration"));
+
+static cl::opt<std::string>
+TimerName("timer-name", cl::desc("Pass timer counted as allocator time"),
+          cl::init("Register Allocator"));
+
+// The pass timers have no public accessor, so the allocator time is read back
+// from the report of TimerGroup::printAll, which also resets the timers for
+// the next iteration. The wall time column is used because it is the only one
+// that is always printed; with the process pinned to one core it matches the
+// user time.
+static bool readAllocatorTime(double &Seconds) {
+  std::string Report;
+  raw_string_ostream OS(Report);
+  TimerGroup::printAll(OS);
+  OS.flush();
+
+  bool Found = false;
+  Seconds = 0;
+  SmallVector<StringRef, 64> Lines;
+  StringRef(Report).split(Lines, '\n');
+  for (StringRef Line : Lines) {
+    size_t Pct = Line.rfind("%)");
+    if (Pct == StringRef::npos)
+      continue;
+    StringRef Name = Line.substr(Pct + 2).trim();
+    if (!Name.contains(TimerName))
+      continue;
+    StringRef Cols = Line.substr(0, Pct);
+    Cols = Cols.substr(0, Cols.rfind('(')).rtrim();
+    double Wall;
+    if (Cols.substr(Cols.rfind(' ') + 1).getAsDouble(Wall))
+      continue;
+    Seconds += Wall;
+    Found = true;
+  }
+  return Found;
+}
+
+// Make Name the allocator of the next pipelines, as -regalloc=Name would.
+static bool selectAllocator(StringRef Name) {
+  for (RegisterRegAlloc *R = RegisterRegAlloc::getList(); R; R = R->getNext()) {
+    if (R->getName() == Name) {
+      RegisterRegAlloc::setDefault(R->getCtor());
+      return true;
+    }
+  }
+  errs() << "regalloc-timer: unknown register allocator '" << Name << "'\n";
+  return false;
+}
+
+// Run the code generation pipeline on a clone of M, writing the object file
+// to memory.
+static bool runCodeGen(const Module &M, TargetMachine &TM) {
+  std::unique_ptr<Module> Clone = CloneModule(&M);
+  legacy::PassManager PM;
+  TargetLibraryInfoImpl TLII(Triple(Clone->getTargetTriple()));
+  PM.add(new TargetLibraryInfoWrapperPass(TLII));
+
+  SmallString<0> Buffer;
+  raw_svector_ostream OS(Buffer);
+  if (TM.addPassesToEmitFile(PM, OS, TargetMachine::CGFT_ObjectFile)) {
+    errs() << "regalloc-timer: target does not support object emission\n";
+    return false;
+  }
+  PM.run(*Clone);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  llvm_shutdown_obj Y;
+
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  InitializeAllAsmPrinters();
+  InitializeAllAsmParsers();
+
+  PassRegistry *Registry = PassRegistry::getPassRegistry();
+  initializeCore(*Registry);
+  initializeCodeGen(*Registry);
+  initializeLoopStrengthReducePass(*Registry);
+  initializeLowerIntrinsicsPass(*Registry);
+  initializeUnreachableBlockElimLegacyPassPass(*Registry);
+
+  cl::ParseCommandLineOptions(argc, argv, "in-process register allocator timer\n");
+
+  LLVMContext Context;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseIRFile(InputFilename, Err, Context);
+  if (!M) {
+    Err.print(argv[0], errs());
+    return 1;
+  }
+
+  if (!TargetTriple.empty())
+    M->setTargetTriple(Triple::normalize(TargetTriple));
+  Triple TheTriple(M->getTargetTriple());
+  if (TheTriple.getTriple().empty())
+    TheTriple.setTriple(sys::getDefaultTargetTriple());
+
+  std::string Error;
+  const Target *TheTarget = TargetRegistry::lookupTarget(MArch, TheTriple, Error);
+  if (!TheTarget) {
+    errs() << argv[0] << ": " << Error << "\n";
+    return 1;
+  }
+
+  CodeGenOpt::Level OLvl = CodeGenOpt::Default;
+  switch (OptLevel) {
+  default:
+    errs() << argv[0] << ": invalid optimization level.\n";
+    return 1;
+  case ' ': break;
+  case '0': OLvl = CodeGenOpt::None; break;
+  case '1': OLvl = CodeGenOpt::Less; break;
+  case '2': OLvl = CodeGenOpt::Default; break;
+  case '3': OLvl = CodeGenOpt::Aggressive; break;
+  }
+
+  TargetOptions Options = InitTargetOptionsFromCodeGenFlags();
+  std::unique_ptr<TargetMachine> TM(TheTarget->createTargetMachine(
+      TheTriple.getTriple(), getCPUStr(), getFeaturesStr(), Options,
+      getRelocModel(), CMModel, OLvl));
+  if (!TM) {
+    errs() << argv[0] << ": could not allocate target machine\n";
+    return 1;
+  }
+  M->setDataLayout(TM->createDataLayout());
+
+  // Without -allocators, the pipeline uses -regalloc or the target default.
+  std::vector<std::string> Names(Allocators.begin(), Allocators.end());
+  if (Names.empty())
+    Names.push_back("default");
+
+  TimePassesIsEnabled = true;
+  outs() << "iteration,allocator,regalloc_seconds,codegen_seconds\n";
+  for (int I = 1 - (int)Warmups; I <= (int)Iterations; ++I) {
+    for (const std::string &Name : Names) {
+      if (!Allocators.empty() && !selectAllocator(Name))
+        return 1;
+
+      auto Start = std::chrono::steady_clock::now();
+      if (!runCodeGen(*M, *TM))
+        return 1;
+      std::chrono::duration<double> CodeGen =
+          std::chrono::steady_clock::now() - Start;
+
+      double RegAlloc;
+      if (!readAllocatorTime(RegAlloc)) {
+        errs() << argv[0] << ": no \"" << TimerName << "\" pass timer\n";
+        return 1;
+      }
+      if (I > 0)
+        outs() << I << "," << Name << "," << format("%.6f", RegAlloc) << ","
+               << format("%.6f", CodeGen.count()) << "\n";
+    }
+  }
+  TimePassesIsEnabled = false;
+  return 0;
+}
@@ -0,0 +1,98 @@
+#!/bin/bash
+# Run a single benchmark job and print "metric,allocator,tu,iteration,value".
+#
+# Usage: run-benchmark-job.sh METRIC ALLOCATOR TU ITERATION [TARGET]
+#
+# Called by run-benchmark.sh through xargs, which sets BENCH_SLOT to the job
+# slot so each slot is pinned to its own core from BENCH_CORES. Iterations
+# below 1 are warm-ups: they are run but nothing is printed. Results for a
+# TARGET other than "host" (see targets.sh) are reported as tu "TU@TARGET".
+set -e
+
+cd "$(dirname "$(readlink -f "$0")")"
+source tccgen-flags.sh
+source allocators.sh
+source targets.sh
+
+METRIC="$1"
+ALLOC="$2"
+TU="$3"
+ITER="$4"
+TARGET="${5:-host}"
+FLAGS=$(allocator_flags "$ALLOC")
+LLC_FLAGS="-relocation-model=pic $(target_flags "$TARGET") $FLAGS"
+BC_FILE="$BENCH_WORK/$TU.bc"
+OBJ_FILE="$BENCH_WORK/$TU.$ALLOC.$BENCH_SLOT.o"
+LABEL="$TU"
+if [ "$TARGET" != "host" ]; then
+	LABEL="$TU@$TARGET"
+fi
+
+CORES=($BENCH_CORES)
+PIN=""
+if [ "${#CORES[@]}" -gt 0 ]; then
+	PIN="taskset -c ${CORES[$((BENCH_SLOT % ${#CORES[@]}))]}"
+fi
+
+case "$METRIC" in
+cc-time)
+	# User time of the register allocator pass, as reported by -time-passes.
+	VALUE=$($PIN llc-4.0 $LLC_FLAGS -time-passes "$BC_FILE" -filetype=obj \
+		-o /dev/null 2>&1 >/dev/null | grep "Register Allocator" |
+		awk '{ print $1; exit }')
+	;;
+bin-size)
+	$PIN llc-4.0 $LLC_FLAGS "$BC_FILE" -filetype=obj -o "$OBJ_FILE"
+	VALUE=$(stat -c %s "$OBJ_FILE")
+	rm -f "$OBJ_FILE"
+	;;
+spills|reloads)
+	# Spill and reload instructions, counted from the comments the asm
+	# printer adds to them ("8-byte Spill", "4-byte Folded Reload").
+	KIND=$([ "$METRIC" == "spills" ] && echo Spill || echo Reload)
+	$PIN llc-4.0 $LLC_FLAGS "$BC_FILE" -filetype=asm -o "$OBJ_FILE"
+	VALUE=$(grep -cE -- "-byte (Folded )?$KIND\$" "$OBJ_FILE" || true)
+	rm -f "$OBJ_FILE"
+	;;
+spill-cost)
+	# Spill and reload instructions weighted by 10^loop depth, the static
+	# estimate the allocators use; the depth comes from the "Depth=N" comment
+	# the asm printer puts under the label of every block in a loop. Blocks
+	# start at a label or at a "BB#N:" comment, and the comment leader depends
+	# on the target: # on x86, // on AArch64, @ on ARM, ; on others.
+	$PIN llc-4.0 $LLC_FLAGS "$BC_FILE" -filetype=asm -o "$OBJ_FILE"
+	VALUE=$(awk '/^[^ \t#@;\/][^ \t]*:/ || /^[ \t]*(#|\/\/|@|;)[ \t]*BB#[0-9]+:/ { depth = 0 }
+		/(#|\/\/|@|;).*Depth=[0-9]+/ { match($0, /Depth=[0-9]+/); depth = substr($0, RSTART + 6, RLENGTH - 6) + 0 }
+		/-byte (Folded )?(Spill|Reload)$/ { cost += 10 ^ depth }
+		END { printf "%.0f\n", cost }' "$OBJ_FILE")
+	rm -f "$OBJ_FILE"
+	;;
+ra-time)
+	# Every iteration runs in this job, on one parsed module; print them all.
+	TIMER="./regalloc-timer/regalloc-timer"
+	$PIN "$TIMER" $LLC_FLAGS -n "$BENCH_ITERATIONS" -warmup "$BENCH_WARMUPS" \
+		"$BC_FILE" | awk -F, -v prefix="$METRIC,$ALLOC,$LABEL" \
+		'NR > 1 { print prefix "," $1 "," $3 }'
+	exit "${PIPESTATUS[0]}"
+	;;
+tcc-time)
+	# User time of the tcc built with ALLOC (see build-benchmark.sh).
+	TCC_EXEC="./build/tinycc-$ALLOC/bin/tcc"
+	TIMEFORMAT=%U
+	VALUE=$( { time $PIN "$TCC_EXEC" -o "$OBJ_FILE" -c "tinycc/$TU" \
+		$TCCGEN_DEFINES -O2 $TCCGEN_CFLAGS -O2 >/dev/null 2>&1; } 2>&1)
+	rm -f "$OBJ_FILE"
+	;;
+*)
+	echo "Unknown metric: $METRIC" >&2
+	exit 1
+	;;
+esac
+
+if [ -z "$VALUE" ]; then
+	echo "No $METRIC result for $ALLOC on $LABEL" >&2
+	exit 1
+fi
+if [ "$ITER" -gt 0 ]; then
+	echo "$METRIC,$ALLOC,$LABEL,$ITER,$VALUE"
+fi
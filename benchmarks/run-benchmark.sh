@@ -0,0 +1,191 @@
+#!/bin/bash
+# Parallel benchmark driver.
+#
+# Runs independent compile jobs in parallel, each pinned to its own core, and
+# interleaves the allocators inside every iteration (rotating their order) so
+# slow drift of the machine is spread evenly over all of them. The samples are
+# summarized by summarize.awk into a single JSON (or CSV) file with the median,
+# MAD and pairwise Mann-Whitney tests of every allocator, and the ratio of each
+# median to the one of ours (e.g. the spill-cost of ours-loop and ours-freq).
+#
+# By default only tccgen.c is measured; -s all measures every tinycc source
+# and adds a whole-program ("all") aggregate of each metric.
+#
+# Metrics:
+#   cc-time   user time of the register allocator pass (llc -time-passes)
+#   bin-size  object file size in bytes (deterministic, measured once)
+#   tcc-time  user time of the tcc built by build-benchmark.sh
+#   ra-time   register allocator time measured in-process by regalloc-timer,
+#             which runs all iterations of a job on one parsed module
+#   spills    spill instructions in the generated assembly (deterministic)
+#   reloads   reload instructions in the generated assembly (deterministic)
+#   spill-cost  spills and reloads weighted by 10^loop depth (deterministic)
+#
+# With -t the same bitcode is also compiled for other targets through
+# llc -mtriple (see targets.sh); their results are reported as "TU@TARGET".
+set -e
+
+cd "$(dirname "$(readlink -f "$0")")"
+source tccgen-flags.sh
+source allocators.sh
+source targets.sh
+
+METRICS="cc-time"
+ITERATIONS=20
+WARMUPS=10
+JOBS=$(( $(nproc) / 2 ))
+SELECTED=""
+FORMAT="json"
+OUTPUT=""
+GATE=0
+SOURCES="$TCCGEN_SRC"
+SELECTED_TARGETS="host"
+
+function usage() {
+	cat <<EOF
+Usage: $0 [options]
+  -m METRICS     comma separated list of cc-time, bin-size, tcc-time, ra-time,
+                 spills, reloads, spill-cost ($METRICS)
+  -n ITERATIONS  timed iterations per allocator ($ITERATIONS)
+  -w WARMUPS     discarded warm-up iterations per allocator ($WARMUPS)
+  -j JOBS        parallel jobs, one pinned core each ($JOBS)
+  -a ALLOCATORS  comma separated subset of: $(allocator_names | paste -sd,)
+  -s SOURCES     comma separated tinycc sources, or "all" ($SOURCES)
+  -t TARGETS     comma separated targets, or "all": $(target_names | paste -sd,)
+  -f FORMAT      json or csv ($FORMAT)
+  -o FILE        output file (results/benchmark.FORMAT)
+  -g             check the results against the baseline (compare-baseline.sh)
+EOF
+	exit "$1"
+}
+
+while getopts "m:n:w:j:a:s:t:f:o:gh" opt; do
+	case "$opt" in
+	m) METRICS="$OPTARG" ;;
+	n) ITERATIONS="$OPTARG" ;;
+	w) WARMUPS="$OPTARG" ;;
+	j) JOBS="$OPTARG" ;;
+	a) SELECTED="$OPTARG" ;;
+	s) SOURCES="$OPTARG" ;;
+	t) SELECTED_TARGETS="$OPTARG" ;;
+	f) FORMAT="$OPTARG" ;;
+	o) OUTPUT="$OPTARG" ;;
+	g) GATE=1 ;;
+	h) usage 0 ;;
+	*) usage 1 ;;
+	esac
+done
+
+[ "$JOBS" -ge 1 ] || JOBS=1
+if [ "$GATE" -eq 1 ] && [ "$FORMAT" != "json" ]; then
+	echo "The baseline check needs -f json" >&2
+	exit 1
+fi
+if [ -z "$SELECTED" ]; then
+	NAMES=($(allocator_names))
+else
+	NAMES=(${SELECTED//,/ })
+	for name in "${NAMES[@]}"; do
+		allocator_flags "$name" >/dev/null
+	done
+fi
+# Backends missing from llc-4.0 (RISC-V is experimental in LLVM 4.0) are
+# skipped with a warning instead of failing every job.
+if [ "$SELECTED_TARGETS" == "all" ]; then
+	SELECTED_TARGETS=$(target_names | paste -sd,)
+fi
+TARGET_NAMES=()
+for target in ${SELECTED_TARGETS//,/ }; do
+	target_flags "$target" >/dev/null
+	if target_available "$target"; then
+		TARGET_NAMES+=("$target")
+	else
+		echo "Skipping target $target: not built into llc-4.0" >&2
+	fi
+done
+RESULTS_DIR="results"
+OUTPUT="${OUTPUT:-$RESULTS_DIR/benchmark.$FORMAT}"
+RAW_FILE="$RESULTS_DIR/benchmark-raw.csv"
+if [ "$SOURCES" == "all" ]; then
+	TINYCC_SRCS="$TINYCC_ALL_SRC"
+else
+	TINYCC_SRCS="${SOURCES//,/ }"
+fi
+
+# Expand the CPU affinity list of this shell ("0-3,8") into "0 1 2 3 8".
+function allowed_cores() {
+	local range
+	for range in $(taskset -cp $$ | sed 's/.*: //' | tr ',' ' '); do
+		seq "${range%-*}" "${range#*-}"
+	done | paste -sd' '
+}
+
+export BENCH_ITERATIONS=$ITERATIONS BENCH_WARMUPS=$WARMUPS
+export BENCH_WORK=$(mktemp -d /tmp/regalloc-bench.XXXXXX)
+export BENCH_CORES=$(allowed_cores)
+trap 'rm -rf "$BENCH_WORK"' EXIT
+
+# Two jobs sharing a core would measure each other, never run more than that.
+CORE_COUNT=$(echo $BENCH_CORES | wc -w)
+if [ "$CORE_COUNT" -gt 0 ] && [ "$JOBS" -gt "$CORE_COUNT" ]; then
+	echo "Only $CORE_COUNT cores available, using $CORE_COUNT jobs" >&2
+	JOBS=$CORE_COUNT
+fi
+
+mkdir -p "$RESULTS_DIR"
+
+# The bitcode is the same for every allocator, emit it once.
+if [[ ",$METRICS," =~ ,(cc-time|bin-size|ra-time|spills|reloads|spill-cost), ]]; then
+	for tu in $TINYCC_SRCS; do
+		echo "Emitting bitcode for $tu..."
+		clang-4.0 -emit-llvm -o "$BENCH_WORK/$tu.bc" -c "tinycc/$tu" \
+			$TCCGEN_DEFINES $TCCGEN_CFLAGS
+	done
+fi
+
+# One job per line: "metric allocator tu iteration target". Within an
+# iteration the allocator order is rotated, so no allocator always runs first
+# or last.
+function job_list() {
+	local metric iters warmups targets i k n
+	n=${#NAMES[@]}
+	for metric in ${METRICS//,/ }; do
+		iters=$ITERATIONS
+		warmups=$WARMUPS
+		targets="${TARGET_NAMES[*]}"
+		case "$metric" in
+		# Deterministic, or iterating inside a single job.
+		bin-size|spills|reloads|spill-cost|ra-time)
+			iters=1
+			warmups=0
+			;;
+		# The tcc binaries only run on the host.
+		tcc-time)
+			targets="host"
+			;;
+		esac
+		for i in $(seq $((1 - warmups)) "$iters"); do
+			for k in $(seq 0 $((n - 1))); do
+				for target in $targets; do
+					for tu in $TINYCC_SRCS; do
+						echo "$metric ${NAMES[$(( (k + i + warmups) % n ))]} $tu $i $target"
+					done
+				done
+			done
+		done
+	done
+}
+
+job_list >"$BENCH_WORK/jobs"
+echo "Running $(wc -l <"$BENCH_WORK/jobs") jobs on $JOBS pinned cores" \
+     "(${BENCH_CORES:-no affinity})..."
+xargs -P "$JOBS" -L 1 --process-slot-var=BENCH_SLOT ./run-benchmark-job.sh \
+	<"$BENCH_WORK/jobs" >"$RAW_FILE"
+
+awk -F, -v format="$FORMAT" -f stats.awk -f summarize.awk "$RAW_FILE" >"$OUTPUT"
+echo "Raw samples: $RAW_FILE"
+echo "Summary: $OUTPUT"
+
+if [ "$GATE" -eq 1 ]; then
+	./compare-baseline.sh "$OUTPUT"
+fi
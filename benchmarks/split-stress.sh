@@ -0,0 +1,77 @@
+#!/bin/bash
+# Microbenchmark of live range splitting on a synthetic, heavily split interval.
+#
+# Generates a function where a value computed in a hot loop is used by N
+# rarely taken branches, each one calling out. -color-split splits the value
+# around every branch and leaves N back-copies of it in the complement
+# interval. With -color-split-mode=speed they are too cold to be hoisted, so
+# SplitEditor::computeRedundantBackCopies() has to find the redundant ones.
+# The allocator time is measured in-process by regalloc-timer for every N, so
+# its growth shows how that step scales; run it against two builds of
+# libRegAllocColor.so to compare them.
+#
+# Prints "branches,iteration,allocator,regalloc_seconds" lines.
+set -e
+
+cd "$(dirname "$(readlink -f "$0")")"
+source allocators.sh
+
+ALLOC="ours"
+ITERATIONS=10
+WARMUPS=3
+SIZES="100 200 400 800 1600"
+
+function usage() {
+	cat <<EOF
+Usage: $0 [options] [BRANCHES...]
+  -a ALLOCATOR   one of: $(allocator_names | grep -v '^llvm-' | paste -sd,) ($ALLOC)
+  -n ITERATIONS  timed iterations per size ($ITERATIONS)
+  -w WARMUPS     discarded warm-up iterations per size ($WARMUPS)
+  BRANCHES       branches using the split value ($SIZES)
+EOF
+	exit "$1"
+}
+
+while getopts "a:n:w:h" opt; do
+	case "$opt" in
+	a) ALLOC="$OPTARG" ;;
+	n) ITERATIONS="$OPTARG" ;;
+	w) WARMUPS="$OPTARG" ;;
+	h) usage 0 ;;
+	*) usage 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+if [ $# -gt 0 ]; then
+	SIZES="$*"
+fi
+
+FLAGS="$(allocator_flags "$ALLOC") -color-split -color-split-mode=speed"
+TIMER="./regalloc-timer/regalloc-timer"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# gen_source N - print the synthetic function with N branches.
+function gen_source() {
+	local k
+	echo "extern void use(long);"
+	echo "long stress(long *p, long n) {"
+	echo "  long s = 0;"
+	echo "  for (long i = 0; i < n; i++) {"
+	echo "    long v = p[i] * 3 + 1;"
+	for k in $(seq 1 "$1"); do
+		echo "    if (__builtin_expect(p[i + $k] == $k, 0)) { p[$k] += v; use(v); }"
+	done
+	echo "    s += v;"
+	echo "  }"
+	echo "  return s;"
+	echo "}"
+}
+
+echo "branches,iteration,allocator,regalloc_seconds"
+for n in $SIZES; do
+	gen_source "$n" > "$WORK/stress-$n.c"
+	clang-4.0 -O1 -c -emit-llvm "$WORK/stress-$n.c" -o "$WORK/stress-$n.bc"
+	$TIMER $FLAGS -n "$ITERATIONS" -warmup "$WARMUPS" "$WORK/stress-$n.bc" |
+		awk -F, -v prefix="$n" 'NR > 1 { print prefix "," $1 "," $2 "," $3 }'
+done
@@ -0,0 +1,102 @@
+# Statistics helpers shared by the benchmark awk scripts. Arrays are 1-based
+# and passed along with their length. Only POSIX awk features are used, so the
+# scripts also run with mawk.
+
+# sort_values(a, n) - sort a[1..n] numerically, in place (shell sort).
+function sort_values(a, n,    gap, i, j, v) {
+	for (gap = int(n / 2); gap > 0; gap = int(gap / 2)) {
+		for (i = gap + 1; i <= n; i++) {
+			v = a[i]
+			for (j = i; j > gap && a[j - gap] > v; j -= gap)
+				a[j] = a[j - gap]
+			a[j] = v
+		}
+	}
+}
+
+# median(a, n) - median of a[1..n]; a is left untouched.
+function median(a, n,    s, i) {
+	if (n == 0)
+		return 0
+	for (i = 1; i <= n; i++)
+		s[i] = a[i]
+	sort_values(s, n)
+	if (n % 2)
+		return s[(n + 1) / 2]
+	return (s[n / 2] + s[n / 2 + 1]) / 2
+}
+
+# mad(a, n, med) - median absolute deviation of a[1..n] around med.
+function mad(a, n, med,    d, i) {
+	for (i = 1; i <= n; i++)
+		d[i] = a[i] > med ? a[i] - med : med - a[i]
+	return median(d, n)
+}
+
+# erfc(x) - complementary error function (Abramowitz & Stegun 7.1.26, with
+# an absolute error below 1.5e-7, which is plenty for p-values).
+function erfc(x,    t, y, neg) {
+	neg = x < 0
+	if (neg)
+		x = -x
+	t = 1 / (1 + 0.3275911 * x)
+	y = t * (0.254829592 + t * (-0.284496736 + t * (1.421413741 + \
+	    t * (-1.453152027 + t * 1.061405429)))) * exp(-x * x)
+	return neg ? 2 - y : y
+}
+
+# mann_whitney(a, na, b, nb, res) - two-sided Mann-Whitney U test of a[1..na]
+# against b[1..nb], using the normal approximation with tie and continuity
+# corrections. Stores U (for a), z and p in res["u"], res["z"] and res["p"].
+function mann_whitney(a, na, b, nb, res,    v, g, n, i, j, k, rank, ra, ties,
+                      mu, sigma, u, z) {
+	n = na + nb
+	for (i = 1; i <= na; i++) {
+		v[i] = a[i]
+		g[i] = 0
+	}
+	for (i = 1; i <= nb; i++) {
+		v[na + i] = b[i]
+		g[na + i] = 1
+	}
+	# Sort values and group tags together (insertion sort keeps it stable).
+	for (i = 2; i <= n; i++) {
+		k = v[i]
+		j = g[i]
+		for (rank = i - 1; rank >= 1 && v[rank] > k; rank--) {
+			v[rank + 1] = v[rank]
+			g[rank + 1] = g[rank]
+		}
+		v[rank + 1] = k
+		g[rank + 1] = j
+	}
+	# Assign average ranks to runs of ties and sum the ranks of a.
+	ra = 0
+	ties = 0
+	for (i = 1; i <= n; i = j + 1) {
+		for (j = i; j < n && v[j + 1] == v[i]; j++)
+			;
+		rank = (i + j) / 2
+		for (k = i; k <= j; k++)
+			if (g[k] == 0)
+				ra += rank
+		k = j - i + 1
+		ties += k * k * k - k
+	}
+	u = ra - na * (na + 1) / 2
+	mu = na * nb / 2
+	sigma = 0
+	if (n > 1)
+		sigma = sqrt(na * nb / 12 * ((n + 1) - ties / (n * (n - 1))))
+	res["u"] = u
+	if (sigma == 0) {
+		res["z"] = 0
+		res["p"] = 1
+		return
+	}
+	z = u - mu
+	z = z > 0.5 ? z - 0.5 : (z < -0.5 ? z + 0.5 : 0)
+	z /= sigma
+	res["z"] = z
+	res["p"] = erfc((z < 0 ? -z : z) / sqrt(2))
+}
@@ -0,0 +1,174 @@
+# Summarize raw benchmark samples into a single CSV or JSON file.
+#
+# Input lines are "metric,allocator,tu,iteration,value" as printed by
+# run-benchmark-job.sh. For each (metric, tu, allocator) the sample count,
+# median and MAD are reported, and every pair of allocators measured on the
+# same (metric, tu) is compared with a Mann-Whitney U test. Each summary also
+# gives the ratio of its median to the one of the `base` allocator (default
+# "ours") on the same (metric, tu), e.g. the spill-cost of ours-loop and
+# ours-freq against ours; it is left out when base was not measured there or
+# its median is 0.
+#
+# When a metric was measured on more than one tu, a whole-program record with
+# tu "all" is added: its samples are the per-iteration sums over every tu, so
+# they only exist for iterations where all of them were measured. Results of
+# other targets ("tu@target") get their own "all@target" record.
+#
+# Usage: awk -F, -v format=json|csv [-v base=ALLOCATOR] -f stats.awk \
+#            -f summarize.awk raw.csv
+# JSON output keeps one record per line, so it stays easy to read back with
+# awk.
+
+BEGIN {
+	if (format == "")
+		format = "json"
+	if (base == "")
+		base = "ours"
+}
+
+NF == 5 {
+	key = $1 SUBSEP $3
+	if (!(key in seen_key)) {
+		seen_key[key] = 1
+		keys[++nkeys] = key
+	}
+	if (!((key, $2) in count)) {
+		nalloc[key]++
+		alloc_of[key, nalloc[key]] = $2
+	}
+	count[key, $2]++
+	sample[key, $2, count[key, $2]] = $5
+
+	# Whole-program totals are kept per target: "x.c@arm" adds to "all@arm".
+	group = $1 SUBSEP (index($3, "@") ? substr($3, index($3, "@")) : "")
+	if (!((group, $3) in seen_tu)) {
+		seen_tu[group, $3] = 1
+		ntu[group]++
+	}
+	if (!((group, $2, $4) in total)) {
+		iters[group, $2] = iters[group, $2] " " $4
+		total[group, $2, $4] = 0
+	}
+	total[group, $2, $4] += $5
+	total_tus[group, $2, $4]++
+}
+
+# add_whole_program() - append the "all" records described above.
+function add_whole_program(    k, n, key, group, target, i, alloc, wkey, it,
+                             nit, j) {
+	n = nkeys
+	for (k = 1; k <= n; k++) {
+		split(keys[k], parts, SUBSEP)
+		target = index(parts[2], "@") ? substr(parts[2], index(parts[2], "@")) : ""
+		group = parts[1] SUBSEP target
+		wkey = parts[1] SUBSEP "all" target
+		if (ntu[group] < 2 || (wkey in seen_key))
+			continue
+		seen_key[wkey] = 1
+		keys[++nkeys] = wkey
+		for (i = 1; i <= nalloc[keys[k]]; i++) {
+			alloc = alloc_of[keys[k], i]
+			nalloc[wkey]++
+			alloc_of[wkey, nalloc[wkey]] = alloc
+			nit = split(iters[group, alloc], it, " ")
+			for (j = 1; j <= nit; j++) {
+				if (total_tus[group, alloc, it[j]] != ntu[group])
+					continue
+				count[wkey, alloc]++
+				sample[wkey, alloc, count[wkey, alloc]] = total[group, alloc, it[j]]
+			}
+		}
+	}
+}
+
+# fmt(x) - print numbers with enough precision for microsecond timings.
+function fmt(x) {
+	return sprintf("%.6g", x)
+}
+
+function samples_json(key, alloc,    i, s) {
+	s = ""
+	for (i = 1; i <= count[key, alloc]; i++)
+		s = s (i > 1 ? ", " : "") fmt(sample[key, alloc, i])
+	return "[" s "]"
+}
+
+# median_of(key, alloc) - median of the samples of alloc on key.
+function median_of(key, alloc,    i, v) {
+	for (i = 1; i <= count[key, alloc]; i++)
+		v[i] = sample[key, alloc, i]
+	return median(v, count[key, alloc])
+}
+
+END {
+	add_whole_program()
+
+	if (format == "csv")
+		print "kind,metric,tu,allocator,other,n,median,mad,u,z,p,ratio"
+	else
+		print "{\n  \"records\": ["
+
+	first = 1
+	for (k = 1; k <= nkeys; k++) {
+		key = keys[k]
+		split(key, parts, SUBSEP)
+		base_med = (key, base) in count ? median_of(key, base) : 0
+		for (i = 1; i <= nalloc[key]; i++) {
+			alloc = alloc_of[key, i]
+			n = count[key, alloc]
+			for (j = 1; j <= n; j++)
+				a[j] = sample[key, alloc, j]
+			med = median(a, n)
+			dev = mad(a, n, med)
+			ratio = base_med != 0 && n ? fmt(med / base_med) : ""
+			if (format == "csv") {
+				print "summary," parts[1] "," parts[2] "," alloc ",," n "," \
+				      fmt(med) "," fmt(dev) ",,,," ratio
+			} else {
+				printf "%s    {\"metric\": \"%s\", \"tu\": \"%s\", " \
+				       "\"allocator\": \"%s\", \"n\": %d, \"median\": %s, " \
+				       "\"mad\": %s, %s\"samples\": %s}", first ? "" : ",\n",
+				       parts[1], parts[2], alloc, n, fmt(med), fmt(dev),
+				       ratio == "" ? "" : "\"ratio\": " ratio ", ",
+				       samples_json(key, alloc)
+				first = 0
+			}
+		}
+	}
+
+	if (format != "csv")
+		print "\n  ],\n  \"comparisons\": ["
+
+	first = 1
+	for (k = 1; k <= nkeys; k++) {
+		key = keys[k]
+		split(key, parts, SUBSEP)
+		for (i = 1; i <= nalloc[key]; i++) {
+			for (j = i + 1; j <= nalloc[key]; j++) {
+				x = alloc_of[key, i]
+				y = alloc_of[key, j]
+				nx = count[key, x]
+				ny = count[key, y]
+				for (s = 1; s <= nx; s++)
+					a[s] = sample[key, x, s]
+				for (s = 1; s <= ny; s++)
+					b[s] = sample[key, y, s]
+				mann_whitney(a, nx, b, ny, res)
+				if (format == "csv") {
+					print "compare," parts[1] "," parts[2] "," x "," y ",,,," \
+					      fmt(res["u"]) "," fmt(res["z"]) "," fmt(res["p"]) ","
+				} else {
+					printf "%s    {\"metric\": \"%s\", \"tu\": \"%s\", " \
+					       "\"allocator\": \"%s\", \"other\": \"%s\", " \
+					       "\"u\": %s, \"z\": %s, \"p\": %s}", first ? "" : ",\n",
+					       parts[1], parts[2], x, y, fmt(res["u"]),
+					       fmt(res["z"]), fmt(res["p"])
+					first = 0
+				}
+			}
+		}
+	}
+
+	if (format != "csv")
+		print "\n  ]\n}"
+}
@@ -0,0 +1,49 @@
+#!/bin/bash
+# Targets of the cross-target benchmarks, as "name|llc backend|triple". The
+# same bitcode is compiled for each of them with llc -mtriple; "host" keeps the
+# triple of the bitcode.
+TARGETS=(
+	"host||"
+	"x86-64|x86-64|x86_64-unknown-linux-gnu"
+	"aarch64|aarch64|aarch64-unknown-linux-gnu"
+	"arm|arm|armv7a-unknown-linux-gnueabihf"
+	"riscv64|riscv64|riscv64-unknown-linux-gnu"
+)
+
+function target_field() {
+	local entry fields
+	for entry in "${TARGETS[@]}"; do
+		IFS='|' read -r -a fields <<<"$entry"
+		if [ "${fields[0]}" == "$1" ]; then
+			echo "${fields[$2]}"
+			return 0
+		fi
+	done
+	echo "Unknown target: $1" >&2
+	return 1
+}
+
+# target_flags NAME - print the llc flags selecting target NAME.
+function target_flags() {
+	local triple
+	triple=$(target_field "$1" 2) || return 1
+	if [ -n "$triple" ]; then
+		echo "-mtriple=$triple"
+	fi
+}
+
+# target_available NAME - whether llc-4.0 was built with the backend of NAME.
+function target_available() {
+	local backend
+	backend=$(target_field "$1" 1) || return 1
+	[ -z "$backend" ] && return 0
+	llc-4.0 -version | awk -v b="$backend" '$1 == b { found = 1 } END { exit !found }'
+}
+
+# target_names - print the name of every target, one per line.
+function target_names() {
+	local entry
+	for entry in "${TARGETS[@]}"; do
+		echo "${entry%%|*}"
+	done
+}
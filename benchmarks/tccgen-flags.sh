@@ -2,3 +2,6 @@
 export TCCGEN_SRC='tccgen.c'
 export TCCGEN_DEFINES='-DCONFIG_TRIPLET="\"x86_64-linux-gnu\"" -DTCC_TARGET_X86_64       -DONE_SOURCE=0'
 export TCCGEN_CFLAGS='-O0 -Wdeclaration-after-statement -fno-strict-aliasing -Wno-pointer-sign -Wno-sign-compare -Wno-unused-result -Wno-format-truncation -fPIC -I. '
+# Every translation unit of the native x86_64 tcc (ONE_SOURCE=no in
+# Makefile.custom), for the whole-program benchmarks.
+export TINYCC_ALL_SRC='tcc.c libtcc.c tccpp.c tccgen.c tccelf.c tccasm.c tccrun.c x86_64-gen.c x86_64-link.c i386-asm.c'
@@ -0,0 +1,227 @@
+//===-- AllocationCache.cpp - On-disk cache of allocation decisions -------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// File layout: an 8-byte magic, then records of
+//   RecordHeader (magic, decision count, key, checksum) + Decision[count]
+// The checksum is the MD5 of the key and the decisions, so a record torn by a
+// crash or still being appended is rejected, and the scan resumes at the next
+// record magic after it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AllocationCache.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "regalloc"
+
+// Version of the file layout and of the decisions recorded in it, the last
+// byte of the file magic and part of every key. Bump it when either changes,
+// or when the allocator changes the decisions it takes for the same options.
+// A file of another version is started over by the next insert.
+static const char FormatVersion = '3';
+static const char FileMagic[8] = {'R', 'A', 'C', 'O', 'L', 'O', 'R', FormatVersion};
+static const uint32_t RecordMagic = 0x52414331; // "RAC1"
+
+namespace {
+  struct RecordHeader {
+    uint32_t Magic;
+    uint32_t NumDecisions;
+    uint8_t Key[16];
+    uint8_t Checksum[16];
+  };
+}
+
+static void checksum(const uint8_t *Key, const AllocationCache::Decision *D,
+                     uint32_t N, uint8_t *Out) {
+  MD5 Hash;
+  Hash.update(ArrayRef<uint8_t>(Key, 16));
+  Hash.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(D),
+                                N * sizeof(AllocationCache::Decision)));
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  memcpy(Out, &Result, 16);
+}
+
+/// Offset of the first record magic at or after Offset, or Size.
+static uint64_t findRecordMagic(const char *Data, uint64_t Offset,
+                                uint64_t Size) {
+  for (; Offset + sizeof(RecordMagic) <= Size; ++Offset)
+    if (!memcmp(Data + Offset, &RecordMagic, sizeof(RecordMagic)))
+      return Offset;
+  return Size;
+}
+
+AllocationCache &AllocationCache::get(StringRef Dir) {
+  // one cache per directory, a process may run pipelines with several
+  static StringMap<std::unique_ptr<AllocationCache>> Caches;
+  std::unique_ptr<AllocationCache> &C = Caches[Dir];
+  if (!C)
+    C.reset(new AllocationCache(Dir));
+  return *C;
+}
+
+AllocationCache::AllocationCache(StringRef Dir) {
+  SmallString<128> P(Dir);
+  sys::path::append(P, "regalloc-color.cache");
+  Path = P.str();
+  sys::fs::create_directories(Dir);
+  load();
+}
+
+void AllocationCache::load() {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+      MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!BufOrErr)
+    return;
+  Buffer = std::move(*BufOrErr);
+
+  const char *Data = Buffer->getBufferStart();
+  uint64_t Size = Buffer->getBufferSize();
+  if (Size < sizeof(FileMagic) || memcmp(Data, FileMagic, sizeof(FileMagic)))
+    return;
+
+  uint64_t Offset = sizeof(FileMagic);
+  while (Offset + sizeof(RecordHeader) <= Size) {
+    RecordHeader H;
+    memcpy(&H, Data + Offset, sizeof(H));
+    uint64_t Bytes = (uint64_t)H.NumDecisions * sizeof(Decision);
+    bool Valid = H.Magic == RecordMagic && Offset + sizeof(H) + Bytes <= Size;
+
+    std::vector<Decision> D;
+    if (Valid) {
+      D.resize(H.NumDecisions);
+      memcpy(D.data(), Data + Offset + sizeof(H), Bytes);
+      uint8_t Sum[16];
+      checksum(H.Key, D.data(), H.NumDecisions, Sum);
+      Valid = !memcmp(Sum, H.Checksum, sizeof(Sum));
+    }
+
+    // A torn record, left by a killed process, does not hide the records
+    // appended after it: resynchronize on the next record magic.
+    if (!Valid) {
+      Offset = findRecordMagic(Data, Offset + 1, Size);
+      continue;
+    }
+
+    // Later records of the same key win: they were computed more recently.
+    Index[StringRef(reinterpret_cast<const char *>(H.Key), 16)] = Offset;
+    Offset += sizeof(H) + Bytes;
+  }
+}
+
+AllocationCache::Key AllocationCache::computeKey(const MachineFunction &MF,
+                                                 StringRef Strategy,
+                                                 StringRef Options) {
+  std::string MIR;
+  raw_string_ostream OS(MIR);
+  MF.print(OS);
+  OS.flush();
+
+  const TargetMachine &TM = MF.getTarget();
+  MD5 Hash;
+  Hash.update(TM.getTargetTriple().str());
+  Hash.update(TM.getTargetCPU());
+  Hash.update(TM.getTargetFeatureString());
+  Hash.update(StringRef(FileMagic, sizeof(FileMagic)));
+  Hash.update(Strategy);
+  Hash.update(Options);
+  Hash.update(MIR);
+  MD5::MD5Result Result;
+  Hash.final(Result);
+
+  Key K;
+  memcpy(K.Bytes, &Result, sizeof(K.Bytes));
+  return K;
+}
+
+bool AllocationCache::lookup(const Key &K,
+                             std::vector<Decision> &Decisions) const {
+  auto A = Added.find(K.str());
+  if (A != Added.end()) {
+    Decisions = A->second;
+    return true;
+  }
+
+  auto I = Index.find(K.str());
+  if (I == Index.end())
+    return false;
+  const char *Data = Buffer->getBufferStart() + I->second;
+  RecordHeader H;
+  memcpy(&H, Data, sizeof(H));
+  Decisions.resize(H.NumDecisions);
+  memcpy(Decisions.data(), Data + sizeof(H),
+         H.NumDecisions * sizeof(Decision));
+  return true;
+}
+
+void AllocationCache::insert(const Key &K, ArrayRef<Decision> Decisions) {
+  Added[K.str()] = Decisions.vec();
+
+  RecordHeader H;
+  H.Magic = RecordMagic;
+  H.NumDecisions = Decisions.size();
+  memcpy(H.Key, K.Bytes, sizeof(H.Key));
+  checksum(H.Key, Decisions.data(), H.NumDecisions, H.Checksum);
+
+  std::string Record(reinterpret_cast<const char *>(&H), sizeof(H));
+  Record.append(reinterpret_cast<const char *>(Decisions.data()),
+                Decisions.size() * sizeof(Decision));
+
+  // read-write, the magic of a non-empty file is checked before appending
+  int FD = ::open(Path.c_str(), O_RDWR | O_APPEND | O_CREAT, 0666);
+  if (FD < 0)
+    return;
+
+  // The lock keeps records of concurrent processes from interleaving; the
+  // first writer of an empty file also writes the file magic, and a file of
+  // another version is started over. A failed write is cut off again.
+  if (::flock(FD, LOCK_EX) == 0) {
+    off_t Start = ::lseek(FD, 0, SEEK_END);
+    char Magic[sizeof(FileMagic)];
+    ssize_t Read = Start > 0 ? ::pread(FD, Magic, sizeof(Magic), 0) : 0;
+    if (Read < 0)
+      Start = -1;
+    else if (Start > 0 && (Read != sizeof(Magic) ||
+                           memcmp(Magic, FileMagic, sizeof(Magic))))
+      Start = ::ftruncate(FD, 0) == 0 ? 0 : -1;
+
+    if (Start < 0) {
+      ::flock(FD, LOCK_UN);
+      ::close(FD);
+      return;
+    }
+    if (Start == 0)
+      Record.insert(0, FileMagic, sizeof(FileMagic));
+    const char *P = Record.data();
+    size_t Left = Record.size();
+    while (Left) {
+      ssize_t N = ::write(FD, P, Left);
+      if (N <= 0)
+        break;
+      P += N;
+      Left -= N;
+    }
+    if (Left)
+      (void)::ftruncate(FD, Start);
+    ::flock(FD, LOCK_UN);
+  }
+  ::close(FD);
+}
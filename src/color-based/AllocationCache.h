@@ -0,0 +1,93 @@
+//===-- AllocationCache.h - On-disk cache of allocation decisions ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares AllocationCache, a content-addressed store of the
+// decisions taken by RAColorBasedCoalescing on a machine function. Records are
+// keyed by a hash of the pre-allocation MIR, the target, the allocator
+// options and the cache format version, and hold the ordered list of
+// selectOrSplit decisions (assign, requeue-and-assign, spill). Replaying them
+// in order rebuilds the same physical register assignment, spill code and
+// stack slots without coloring.
+//
+// The cache is a single append-only file. Each process maps the file once
+// and indexes the valid records; appends are serialized with flock(), and
+// readers skip torn or corrupted records through their checksum, so
+// concurrent llc processes can share one cache directory.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ALLOCATIONCACHE_H
+#define LLVM_ALLOCATIONCACHE_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm {
+
+class MachineFunction;
+
+class LLVM_LIBRARY_VISIBILITY AllocationCache {
+public:
+  enum DecisionKind : uint32_t {
+    Assign = 0, ///< PhysReg was free and got assigned.
+    // 1 was the spill-the-interferences evict of format version 1.
+    Spill = 2,  ///< The virtual register itself was spilled.
+    Requeue = 3 ///< The interferences on PhysReg were evicted, then assigned.
+  };
+
+  struct Decision {
+    uint32_t VirtReg;
+    uint32_t Kind;
+    uint32_t PhysReg;
+  };
+
+  /// 128-bit content hash of a machine function and the allocator setup.
+  struct Key {
+    uint8_t Bytes[16];
+
+    StringRef str() const {
+      return StringRef(reinterpret_cast<const char *>(Bytes), sizeof(Bytes));
+    }
+  };
+
+  /// Return the cache stored in directory Dir, opening it on first use. Each
+  /// directory has its own instance.
+  static AllocationCache &get(StringRef Dir);
+
+  /// Hash the pre-allocation MIR of MF, its target, the allocator setup and
+  /// the build of the plugin.
+  static Key computeKey(const MachineFunction &MF, StringRef Strategy,
+                        StringRef Options);
+
+  /// Fill Decisions with the record of K. Return false when there is none.
+  bool lookup(const Key &K, std::vector<Decision> &Decisions) const;
+
+  /// Append a record for K. Failures only cost a future cache miss.
+  void insert(const Key &K, ArrayRef<Decision> Decisions);
+
+private:
+  std::string Path;
+  std::unique_ptr<MemoryBuffer> Buffer;
+  StringMap<uint64_t> Index;
+  StringMap<std::vector<Decision>> Added;
+
+  explicit AllocationCache(StringRef Dir);
+
+  void load();
+};
+
+} // end namespace llvm
+
+#endif
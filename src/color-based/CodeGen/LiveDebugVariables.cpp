@@ -20,7 +20,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "LiveDebugVariables.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/IntervalMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/CodeGen/LiveIntervalAnalysis.h"
 #include "llvm/CodeGen/MachineDominators.h"
@@ -32,6 +34,7 @@
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
 #include "llvm/IR/Value.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
@@ -71,7 +74,8 @@ void LiveDebugVariables::getAnalysisUsage(AnalysisUsage &AU) const {
   MachineFunctionPass::getAnalysisUsage(AU);
 }
 
-LiveDebugVariables::LiveDebugVariables() : MachineFunctionPass(ID), pImpl(nullptr) {
+LiveDebugVariables::LiveDebugVariables()
+    : MachineFunctionPass(ID), pImpl(nullptr), ModuleHasDebugInfo(true) {
   initializeLiveDebugVariablesPass(*PassRegistry::getPassRegistry());
 }
 
@@ -240,6 +244,12 @@ public:
   bool splitRegister(unsigned OldLocNo, ArrayRef<unsigned> NewRegs,
                      LiveIntervals &LIS);
 
+  /// splitRegisters - Split, in one pass over the locations, every location
+  /// whose register is a key of Splits. The old registers of the locations
+  /// that changed are added to Changed.
+  void splitRegisters(const DenseMap<unsigned, SmallVector<unsigned, 4>> &Splits,
+                      LiveIntervals &LIS, DenseSet<unsigned> &Changed);
+
   /// rewriteLocations - Rewrite virtual register locations according to the
   /// provided virtual register map.
   void rewriteLocations(VirtRegMap &VRM, const TargetRegisterInfo &TRI);
@@ -279,6 +289,13 @@ class LDVImpl {
   typedef DenseMap<const MDNode *, UserValue*> UVMap;
   UVMap userVarMap;
 
+  /// PendingSplits - Split events recorded by deferSplitRegister, from the old
+  /// register to its new registers, not yet applied to the user values.
+  DenseMap<unsigned, SmallVector<unsigned, 4>> PendingSplits;
+
+  /// PendingNewRegs - The new registers of PendingSplits.
+  DenseSet<unsigned> PendingNewRegs;
+
   /// getUserValue - Find or create a UserValue.
   UserValue *getUserValue(const MDNode *Var, const MDNode *Expr,
                           unsigned Offset, bool IsIndirect, const DebugLoc &DL);
@@ -307,12 +324,17 @@ public:
       : pass(*ps), MF(nullptr), EmitDone(false), ModifiedMF(false) {}
   bool runOnMachineFunction(MachineFunction &mf);
 
+  /// empty - Return true if no user values were collected.
+  bool empty() const { return userValues.empty(); }
+
   /// clear - Release all memory.
   void clear() {
     MF = nullptr;
     userValues.clear();
     virtRegToEqClass.clear();
     userVarMap.clear();
+    PendingSplits.clear();
+    PendingNewRegs.clear();
     // Make sure we call emitDebugValues if the machine function was modified.
     assert((!ModifiedMF || EmitDone) &&
            "Dbg values are not emitted in LDV");
@@ -326,6 +348,13 @@ public:
   /// splitRegister -  Replace all references to OldReg with NewRegs.
   void splitRegister(unsigned OldReg, ArrayRef<unsigned> NewRegs);
 
+  /// deferSplitRegister - Record that OldReg was split into NewRegs, to be
+  /// applied by flushSplits.
+  void deferSplitRegister(unsigned OldReg, ArrayRef<unsigned> NewRegs);
+
+  /// flushSplits - Apply all the recorded split events.
+  void flushSplits();
+
   /// emitDebugValues - Recreate DBG_VALUE instruction from data structures.
   void emitDebugValues(VirtRegMap *VRM);
 
@@ -722,7 +751,10 @@ bool LiveDebugVariables::runOnMachineFunction(MachineFunction &mf) {
   if (!EnableLDV)
     return false;
   if (!mf.getFunction()->getSubprogram()) {
-    removeDebugValues(mf);
+    // Without a compile unit, instruction selection had no debug info to
+    // lower, so walking every instruction would find nothing.
+    if (ModuleHasDebugInfo)
+      removeDebugValues(mf);
     return false;
   }
   if (!pImpl)
@@ -860,6 +892,8 @@ UserValue::splitRegister(unsigned OldReg, ArrayRef<unsigned> NewRegs,
 }
 
 void LDVImpl::splitRegister(unsigned OldReg, ArrayRef<unsigned> NewRegs) {
+  if (virtRegToEqClass.empty())
+    return;
   bool DidChange = false;
   for (UserValue *UV = lookupVirtReg(OldReg); UV; UV = UV->getNext())
     DidChange |= UV->splitRegister(OldReg, NewRegs, *LIS);
@@ -879,6 +913,76 @@ splitRegister(unsigned OldReg, ArrayRef<unsigned> NewRegs, LiveIntervals &LIS) {
     static_cast<LDVImpl*>(pImpl)->splitRegister(OldReg, NewRegs);
 }
 
+void UserValue::
+splitRegisters(const DenseMap<unsigned, SmallVector<unsigned, 4>> &Splits,
+               LiveIntervals &LIS, DenseSet<unsigned> &Changed) {
+  // Iterate backwards so splitLocation can safely erase unused locations. The
+  // locations it appends are new registers, which are never split again.
+  for (unsigned i = locations.size(); i ; --i) {
+    unsigned LocNo = i-1;
+    const MachineOperand *Loc = &locations[LocNo];
+    if (!Loc->isReg())
+      continue;
+    unsigned OldReg = Loc->getReg();
+    auto I = Splits.find(OldReg);
+    if (I == Splits.end())
+      continue;
+    if (splitLocation(LocNo, I->second, LIS))
+      Changed.insert(OldReg);
+  }
+}
+
+void LDVImpl::deferSplitRegister(unsigned OldReg, ArrayRef<unsigned> NewRegs) {
+  if (virtRegToEqClass.empty())
+    return;
+  // A pending new register split again has to see its own split applied
+  // first, so the events can't be reordered past this point.
+  if (PendingNewRegs.count(OldReg))
+    flushSplits();
+  SmallVector<unsigned, 4> &Regs = PendingSplits[OldReg];
+  Regs.append(NewRegs.begin(), NewRegs.end());
+  PendingNewRegs.insert(NewRegs.begin(), NewRegs.end());
+}
+
+void LDVImpl::flushSplits() {
+  if (PendingSplits.empty())
+    return;
+
+  // Visit every equivalence class touched by the events once.
+  SmallPtrSet<UserValue*, 8> Leaders;
+  DenseSet<unsigned> Changed;
+  for (const auto &P : PendingSplits) {
+    UserValue *Leader = lookupVirtReg(P.first);
+    if (!Leader || !Leaders.insert(Leader).second)
+      continue;
+    for (UserValue *UV = Leader; UV; UV = UV->getNext())
+      UV->splitRegisters(PendingSplits, *LIS, Changed);
+  }
+
+  // Map all of the new virtual registers.
+  for (const auto &P : PendingSplits) {
+    if (!Changed.count(P.first))
+      continue;
+    UserValue *UV = lookupVirtReg(P.first);
+    for (unsigned NewReg : P.second)
+      mapVirtReg(NewReg, UV);
+  }
+
+  PendingSplits.clear();
+  PendingNewRegs.clear();
+}
+
+void LiveDebugVariables::deferSplitRegister(unsigned OldReg,
+                                            ArrayRef<unsigned> NewRegs) {
+  if (pImpl)
+    static_cast<LDVImpl*>(pImpl)->deferSplitRegister(OldReg, NewRegs);
+}
+
+void LiveDebugVariables::flushSplits() {
+  if (pImpl)
+    static_cast<LDVImpl*>(pImpl)->flushSplits();
+}
+
 void
 UserValue::rewriteLocations(VirtRegMap &VRM, const TargetRegisterInfo &TRI) {
   // Iterate over locations in reverse makes it easier to handle coalescing.
@@ -990,6 +1094,7 @@ void LDVImpl::emitDebugValues(VirtRegMap *VRM) {
   DEBUG(dbgs() << "********** EMITTING LIVE DEBUG VARIABLES **********\n");
   if (!MF)
     return;
+  flushSplits();
   const TargetInstrInfo *TII = MF->getSubtarget().getInstrInfo();
   for (unsigned i = 0, e = userValues.size(); i != e; ++i) {
     DEBUG(userValues[i]->print(dbgs(), TRI));
@@ -999,12 +1104,17 @@ void LDVImpl::emitDebugValues(VirtRegMap *VRM) {
   EmitDone = true;
 }
 
+bool LiveDebugVariables::empty() const {
+  return !pImpl || static_cast<LDVImpl*>(pImpl)->empty();
+}
+
 void LiveDebugVariables::emitDebugValues(VirtRegMap *VRM) {
   if (pImpl)
     static_cast<LDVImpl*>(pImpl)->emitDebugValues(VRM);
 }
 
 bool LiveDebugVariables::doInitialization(Module &M) {
+  ModuleHasDebugInfo = M.getNamedMetadata("llvm.dbg.cu") != nullptr;
   return Pass::doInitialization(M);
 }
 
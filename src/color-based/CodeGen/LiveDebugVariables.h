@@ -34,6 +34,10 @@ class VirtRegMap;
 class LLVM_LIBRARY_VISIBILITY LiveDebugVariables : public MachineFunctionPass {
   void *pImpl;
 
+  /// ModuleHasDebugInfo - Whether the module has a compile unit. Without one
+  /// there are no DBG_VALUE instructions to collect or remove.
+  bool ModuleHasDebugInfo;
+
 public:
   static char ID; // Pass identification, replacement for typeid
 
@@ -53,6 +57,19 @@ public:
   void splitRegister(unsigned OldReg, ArrayRef<unsigned> NewRegs,
                      LiveIntervals &LIS);
 
+  /// deferSplitRegister - Like splitRegister, but only record the event. The
+  /// recorded events are applied together by flushSplits, which must run
+  /// while the live intervals of OldReg's new registers are still intact.
+  void deferSplitRegister(unsigned OldReg, ArrayRef<unsigned> NewRegs);
+
+  /// flushSplits - Apply the events recorded by deferSplitRegister, walking
+  /// the locations of each user value once. emitDebugValues calls it too.
+  void flushSplits();
+
+  /// empty - Return true if no user variables are tracked in the current
+  /// function, so splitRegister and emitDebugValues have nothing to update.
+  bool empty() const;
+
   /// emitDebugValues - Emit new DBG_VALUE instructions reflecting the changes
   /// that happened during register allocation.
   /// @param VRM Rename virtual registers according to map.
@@ -25,7 +25,9 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/IndexedMap.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/CodeGen/LiveInterval.h"
+#include <deque>
 
 namespace llvm {
 
@@ -34,7 +36,7 @@ class MachineDominatorTree;
 template <class NodeT> class DomTreeNodeBase;
 typedef DomTreeNodeBase<MachineBasicBlock> MachineDomTreeNode;
 
-class LiveRangeCalc {
+class LLVM_LIBRARY_VISIBILITY LiveRangeCalc {
   const MachineFunction *MF;
   const MachineRegisterInfo *MRI;
   SlotIndexes *Indexes;
@@ -64,8 +66,27 @@ class LiveRangeCalc {
   /// in live range splitting (which is ok, since the live ranges of these
   /// registers do not overlap), but the defined/undefined information must
   /// be kept separate for each individual range.
-  /// By convention, EntryInfoMap[&LR] = { Defined, Undefined }.
-  std::map<LiveRange*,std::pair<BitVector,BitVector>> EntryInfoMap;
+  struct EntryInfo {
+    BitVector DefOnEntry;
+    BitVector UndefOnEntry;
+  };
+
+  /// EntryInfos - Pool of entry sets. The first NumEntryInfos belong to the
+  /// live ranges in EntryRanges, in the same order; the others are left over
+  /// from before the last resetLiveOutMap() and are recycled, with their
+  /// storage, by the next ranges.
+  SmallVector<EntryInfo, 4> EntryInfos;
+  unsigned NumEntryInfos;
+
+  /// EntryRanges - The live ranges that have entry sets. A calc only handles
+  /// a few ranges between resets (a register and its subranges, or the
+  /// products of one split), so the index of a range is found by a short
+  /// linear scan.
+  SmallVector<LiveRange*, 4> EntryRanges;
+
+  /// getEntryInfo - Return the entry sets of LR, taking cleared ones from the
+  /// pool the first time LR is seen.
+  EntryInfo &getEntryInfo(LiveRange &LR);
 
   /// Map each basic block where a live range is live out to the live-out value
   /// and its defining block.
@@ -115,6 +136,15 @@ class LiveRangeCalc {
   /// used to add entries directly.
   SmallVector<LiveInBlock, 16> LiveIn;
 
+  /// LiveInIndex - Position in LiveIn of the entry for each block number, or
+  /// ~0u.  Only valid inside updateSSA(), which restores every slot it sets.
+  SmallVector<unsigned, 16> LiveInIndex;
+
+  /// SSAWorkList / SSAPending - Entries of LiveIn that updateSSA() still has
+  /// to (re)visit, and whether an entry is already queued.
+  SmallVector<unsigned, 16> SSAWorkList;
+  BitVector SSAPending;
+
   /// Check if the entry to block @p MBB can be reached by any of the defs
   /// in @p LR. Return true if none of the defs reach the entry to @p MBB.
   bool isDefOnEntry(LiveRange &LR, ArrayRef<SlotIndex> Undefs,
@@ -143,11 +173,29 @@ class LiveRangeCalc {
 
   /// updateSSA - Compute the values that will be live in to all requested
   /// blocks in LiveIn.  Create PHI-def values as required to preserve SSA form.
+  /// An entry is only revisited when the live-out value of its immediate
+  /// dominator or of one of its predecessors changes.
   ///
   /// Every live-in block must be jointly dominated by the added live-out
   /// blocks.  No values are read from the live ranges.
   void updateSSA();
 
+#ifndef NDEBUG
+  /// SweepValue - What the LiveIn sweep found for an entry: a phi-def, or the
+  /// incoming value, if any.
+  struct SweepValue {
+    bool PHI;
+    VNInfo *Value;
+  };
+
+  /// sweepSSA - The sweep updateSSA() used before its work list, run on
+  /// copies: Values gets one result per LiveIn entry, LiveOut the live-out
+  /// values, and the phi-defs are stand-ins allocated in PHIs. The live
+  /// ranges, Map and LiveIn are left untouched.
+  void sweepSSA(SmallVectorImpl<SweepValue> &Values, LiveOutMap &LiveOut,
+                std::deque<VNInfo> &PHIs);
+#endif
+
   /// Transfer information from the LiveIn vector to the live ranges and update
   /// the given @p LiveOuts.
   void updateFromLiveIns();
@@ -164,12 +212,12 @@ class LiveRangeCalc {
   void extendToUses(LiveRange &LR, unsigned Reg, LaneBitmask LaneMask,
                     LiveInterval *LI = nullptr);
 
-  /// Reset Map and Seen fields.
+  /// Reset Map and Seen fields, and return the entry sets to the pool.
   void resetLiveOutMap();
 
 public:
   LiveRangeCalc() : MF(nullptr), MRI(nullptr), Indexes(nullptr),
-                    DomTree(nullptr), Alloc(nullptr) {}
+                    DomTree(nullptr), Alloc(nullptr), NumEntryInfos(0) {}
 
   //===--------------------------------------------------------------------===//
   // High-level interface.
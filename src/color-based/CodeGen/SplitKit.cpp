@@ -135,6 +135,14 @@ void SplitAnalysis::clear() {
   DidRepairRange = false;
 }
 
+void SplitAnalysis::reuseBuffers(SplitAnalysis &Old) {
+  Old.clear();
+  clear();
+  UseSlots.swap(Old.UseSlots);
+  UseBlocks.swap(Old.UseBlocks);
+  ThroughBlocks.swap(Old.ThroughBlocks);
+}
+
 /// analyzeUses - Count instructions, basic blocks, and loops using CurLI.
 void SplitAnalysis::analyzeUses() {
   assert(UseSlots.empty() && "Call clear first");
@@ -347,7 +355,12 @@ SplitEditor::SplitEditor(SplitAnalysis &sa, AliasAnalysis &aa,
       TII(*vrm.getMachineFunction().getSubtarget().getInstrInfo()),
       TRI(*vrm.getMachineFunction().getSubtarget().getRegisterInfo()),
       MBFI(mbfi), Edit(nullptr), OpenIdx(0), SpillMode(SM_Partition),
-      RegAssign(Allocator) {}
+      RegAssign(Allocator) {
+  // Splitting never changes the CFG, so the DFS numbers of the dominator tree
+  // read by buildLadder() and computeRedundantBackCopies() stay valid for the
+  // whole function.
+  MDT.getBase().updateDFSNumbers();
+}
 
 void SplitEditor::reset(LiveRangeEdit &LRE, ComplementSpillMode SM) {
   Edit = &LRE;
@@ -743,6 +756,32 @@ void SplitEditor::removeBackCopies(SmallVectorImpl<VNInfo*> &Copies) {
   }
 }
 
+void SplitEditor::buildLadder() {
+  MachineFunction &MF = VRM.getMachineFunction();
+  const MachineLoopInfo &Loops = SA.Loops;
+
+  Ladder.resize(MF.getNumBlockIDs());
+  for (MachineBasicBlock &MBB : MF) {
+    LadderRung &Rung = Ladder[MBB.getNumber()];
+    Rung.Loop = nullptr;
+    Rung.Up = nullptr;
+    Rung.DFSIn = Rung.DFSOut = 0;
+
+    // Unreachable blocks are not in the dominator tree.
+    MachineDomTreeNode *Node = MDT[&MBB];
+    if (!Node)
+      continue;
+    Rung.DFSIn = Node->getDFSNumIn();
+    Rung.DFSOut = Node->getDFSNumOut();
+
+    Rung.Loop = Loops.getLoopFor(&MBB);
+    if (Rung.Loop) {
+      MachineDomTreeNode *IDom = MDT[Rung.Loop->getHeader()]->getIDom();
+      Rung.Up = IDom ? IDom->getBlock() : nullptr;
+    }
+  }
+}
+
 MachineBasicBlock*
 SplitEditor::findShallowDominator(MachineBasicBlock *MBB,
                                   MachineBasicBlock *DefMBB) {
@@ -750,34 +789,41 @@ SplitEditor::findShallowDominator(MachineBasicBlock *MBB,
     return MBB;
   assert(MDT.dominates(DefMBB, MBB) && "MBB must be dominated by the def.");
 
-  const MachineLoopInfo &Loops = SA.Loops;
-  const MachineLoop *DefLoop = Loops.getLoopFor(DefMBB);
-  MachineDomTreeNode *DefDomNode = MDT[DefMBB];
+  MachineBasicBlock *&Cached =
+      ShallowDominators[std::make_pair(MBB->getNumber(), DefMBB->getNumber())];
+  if (Cached)
+    return Cached;
+
+  if (Ladder.empty())
+    buildLadder();
+  const LadderRung &Def = Ladder[DefMBB->getNumber()];
 
   // Best candidate so far.
   MachineBasicBlock *BestMBB = MBB;
   unsigned BestDepth = UINT_MAX;
 
   for (;;) {
-    const MachineLoop *Loop = Loops.getLoopFor(MBB);
+    const LadderRung &Rung = Ladder[MBB->getNumber()];
 
     // MBB isn't in a loop, it doesn't get any better.  All dominators have a
     // higher frequency by definition.
-    if (!Loop) {
+    if (!Rung.Loop) {
       DEBUG(dbgs() << "Def in BB#" << DefMBB->getNumber() << " dominates BB#"
                    << MBB->getNumber() << " at depth 0\n");
-      return MBB;
+      BestMBB = MBB;
+      break;
     }
 
     // We'll never be able to exit the DefLoop.
-    if (Loop == DefLoop) {
+    if (Rung.Loop == Def.Loop) {
       DEBUG(dbgs() << "Def in BB#" << DefMBB->getNumber() << " dominates BB#"
                    << MBB->getNumber() << " in the same loop\n");
-      return MBB;
+      BestMBB = MBB;
+      break;
     }
 
     // Least busy dominator seen so far.
-    unsigned Depth = Loop->getLoopDepth();
+    unsigned Depth = Rung.Loop->getLoopDepth();
     if (Depth < BestDepth) {
       BestMBB = MBB;
       BestDepth = Depth;
@@ -787,63 +833,75 @@ SplitEditor::findShallowDominator(MachineBasicBlock *MBB,
 
     // Leave loop by going to the immediate dominator of the loop header.
     // This is a bigger stride than simply walking up the dominator tree.
-    MachineDomTreeNode *IDom = MDT[Loop->getHeader()]->getIDom();
+    if (!Rung.Up)
+      break;
 
     // Too far up the dominator tree?
-    if (!IDom || !MDT.dominates(DefDomNode, IDom))
-      return BestMBB;
+    const LadderRung &Up = Ladder[Rung.Up->getNumber()];
+    if (Up.DFSIn < Def.DFSIn || Up.DFSOut > Def.DFSOut)
+      break;
 
-    MBB = IDom->getBlock();
+    MBB = Rung.Up;
   }
+
+  Cached = BestMBB;
+  return BestMBB;
 }
 
 void SplitEditor::computeRedundantBackCopies(
     DenseSet<unsigned> &NotToHoistSet, SmallVectorImpl<VNInfo *> &BackCopies) {
   LiveInterval *LI = &LIS.getInterval(Edit->get(0));
   LiveInterval *Parent = &Edit->getParent();
-  SmallVector<SmallPtrSet<VNInfo *, 8>, 8> EqualVNs(Parent->getNumValNums());
-  SmallPtrSet<VNInfo *, 8> DominatedVNIs;
+
+  // A value is redundant when another value with the same parent value
+  // dominates it. Order the values of each parent value by the DFS number of
+  // their block in the dominator tree, then by def slot: every value dominated
+  // by another one comes after it, inside the [DFSNumIn, DFSNumOut] interval
+  // of its block. One sweep per bucket then finds them all, instead of a
+  // dominates() query for every pair.
+  typedef std::pair<std::pair<unsigned, SlotIndex>, VNInfo *> OrderedVNI;
+  SmallVector<SmallVector<OrderedVNI, 8>, 8> EqualVNs(Parent->getNumValNums());
 
   // Aggregate VNIs having the same value as ParentVNI.
   for (VNInfo *VNI : LI->valnos) {
     if (VNI->isUnused())
       continue;
     VNInfo *ParentVNI = Edit->getParent().getVNInfoAt(VNI->def);
-    EqualVNs[ParentVNI->id].insert(VNI);
+    if (!NotToHoistSet.count(ParentVNI->id))
+      continue;
+    MachineBasicBlock *MBB = LIS.getMBBFromIndex(VNI->def);
+    unsigned DFSIn = MDT.getNode(MBB)->getDFSNumIn();
+    EqualVNs[ParentVNI->id].push_back(
+        std::make_pair(std::make_pair(DFSIn, VNI->def), VNI));
   }
 
   // For VNI aggregation of each ParentVNI, collect dominated, i.e.,
   // redundant VNIs to BackCopies.
   for (unsigned i = 0, e = Parent->getNumValNums(); i != e; ++i) {
-    VNInfo *ParentVNI = Parent->getValNumInfo(i);
-    if (!NotToHoistSet.count(ParentVNI->id))
+    SmallVectorImpl<OrderedVNI> &VNIs = EqualVNs[i];
+    if (VNIs.size() < 2)
       continue;
-    SmallPtrSetIterator<VNInfo *> It1 = EqualVNs[ParentVNI->id].begin();
-    SmallPtrSetIterator<VNInfo *> It2 = It1;
-    for (; It1 != EqualVNs[ParentVNI->id].end(); ++It1) {
-      It2 = It1;
-      for (++It2; It2 != EqualVNs[ParentVNI->id].end(); ++It2) {
-        if (DominatedVNIs.count(*It1) || DominatedVNIs.count(*It2))
-          continue;
-
-        MachineBasicBlock *MBB1 = LIS.getMBBFromIndex((*It1)->def);
-        MachineBasicBlock *MBB2 = LIS.getMBBFromIndex((*It2)->def);
-        if (MBB1 == MBB2) {
-          DominatedVNIs.insert((*It1)->def < (*It2)->def ? (*It2) : (*It1));
-        } else if (MDT.dominates(MBB1, MBB2)) {
-          DominatedVNIs.insert(*It2);
-        } else if (MDT.dominates(MBB2, MBB1)) {
-          DominatedVNIs.insert(*It1);
-        }
-      }
-    }
-    if (!DominatedVNIs.empty()) {
-      forceRecompute(0, ParentVNI);
-      for (auto VNI : DominatedVNIs) {
-        BackCopies.push_back(VNI);
+    std::sort(VNIs.begin(), VNIs.end(), llvm::less_first());
+
+    // The last value that no other one dominates, and the DFS interval of
+    // its block. Values inside the interval are dominated by it.
+    unsigned DomIn = VNIs[0].first.first;
+    unsigned DomOut = MDT.getNode(LIS.getMBBFromIndex(VNIs[0].second->def))
+                          ->getDFSNumOut();
+    bool Dominated = false;
+    for (unsigned j = 1, je = VNIs.size(); j != je; ++j) {
+      unsigned DFSIn = VNIs[j].first.first;
+      if (DomIn <= DFSIn && DFSIn <= DomOut) {
+        BackCopies.push_back(VNIs[j].second);
+        Dominated = true;
+        continue;
       }
-      DominatedVNIs.clear();
+      DomIn = DFSIn;
+      DomOut = MDT.getNode(LIS.getMBBFromIndex(VNIs[j].second->def))
+                   ->getDFSNumOut();
     }
+    if (Dominated)
+      forceRecompute(0, Parent->getValNumInfo(i));
   }
 }
 
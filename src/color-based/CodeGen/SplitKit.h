@@ -163,6 +163,11 @@ public:
   /// new interval.
   void clear();
 
+  /// reuseBuffers - take over the use slot, use block and through block
+  /// storage of Old, an analysis of a previous function, so that the first
+  /// intervals of this one don't grow them again. Old is left cleared.
+  void reuseBuffers(SplitAnalysis &Old);
+
   /// getParent - Return the last analyzed interval.
   const LiveInterval &getParent() const { return *CurLI; }
 
@@ -318,6 +323,27 @@ private:
   /// LiveRangeCalc instance for the complement interval when in spill mode.
   LiveRangeCalc LRCalc[2];
 
+  /// LadderRung - What findShallowDominator() needs to know about a block:
+  /// its innermost loop, the block the search continues from when it leaves
+  /// that loop (the immediate dominator of the loop header), and the DFS
+  /// numbers of the block in the dominator tree for O(1) dominance checks.
+  struct LadderRung {
+    const MachineLoop *Loop;
+    MachineBasicBlock *Up;
+    unsigned DFSIn, DFSOut;
+  };
+
+  /// Ladder - Rungs indexed by block number, built on the first hoist query.
+  /// The CFG doesn't change while the editor is alive, and neither do they.
+  SmallVector<LadderRung, 0> Ladder;
+
+  /// ShallowDominators - Answers of findShallowDominator(), keyed by the
+  /// block numbers of (MBB, DefMBB).
+  DenseMap<std::pair<unsigned, unsigned>, MachineBasicBlock*> ShallowDominators;
+
+  /// buildLadder - Compute the rung of every block of the function.
+  void buildLadder();
+
   /// getLRCalc - Return the LRCalc to use for RegIdx.  In spill mode, the
   /// complement interval can overlap the other intervals, so it gets its own
   /// LRCalc instance.  When not in spill mode, all intervals can share one.
@@ -0,0 +1,92 @@
+//===-- ColorSet.h - Fixed-size sets of colors for the select kernels -----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the sets used by the select kernels of
+// RAColorBasedCoalescing to mark the colors taken by the neighbors of a node.
+// Colors are identified by their position in the candidate list, so a register
+// file of up to 64 or 128 registers fits in one or two words on the stack;
+// larger lists (many extended colors) fall back to a BitVector.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_COLORSET_H
+#define LLVM_COLORSET_H
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace llvm {
+
+template <unsigned MaxColors> class FixedColorSet {
+  static const unsigned NumWords = (MaxColors + 63) / 64;
+  uint64_t Words[NumWords];
+  unsigned Size;
+
+public:
+  explicit FixedColorSet(unsigned Size) : Size(Size) {
+    assert(Size <= MaxColors && "too many colors for this set");
+    for (unsigned i = 0; i != NumWords; ++i)
+      Words[i] = 0;
+  }
+
+  void set(unsigned Idx) { Words[Idx / 64] |= uint64_t(1) << (Idx % 64); }
+
+  /// Number of colors not in the set.
+  unsigned countFree() const {
+    unsigned Taken = 0;
+    for (unsigned i = 0; i != NumWords; ++i)
+      Taken += countPopulation(Words[i]);
+    return Size - Taken;
+  }
+
+  /// Position of the K-th (from 0) color not in the set, or -1.
+  int findFree(unsigned K) const {
+    for (unsigned i = 0; i != NumWords; ++i) {
+      unsigned Bits = std::min(64u, Size - std::min(Size, i * 64));
+      uint64_t Free = ~Words[i];
+      if (Bits < 64)
+        Free &= (uint64_t(1) << Bits) - 1;
+
+      unsigned N = countPopulation(Free);
+      if (K >= N) {
+        K -= N;
+        continue;
+      }
+      // Drop the K lowest free colors, the next one is the answer.
+      while (K--)
+        Free &= Free - 1;
+      return i * 64 + countTrailingZeros(Free);
+    }
+    return -1;
+  }
+};
+
+class DynamicColorSet {
+  BitVector Bits;
+
+public:
+  explicit DynamicColorSet(unsigned Size) : Bits(Size) {}
+
+  void set(unsigned Idx) { Bits.set(Idx); }
+
+  unsigned countFree() const { return Bits.size() - Bits.count(); }
+
+  int findFree(unsigned K) const {
+    for (unsigned Idx = 0, E = Bits.size(); Idx != E; ++Idx)
+      if (!Bits.test(Idx) && K-- == 0)
+        return Idx;
+    return -1;
+  }
+};
+
+} // end namespace llvm
+
+#endif
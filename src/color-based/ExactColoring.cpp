@@ -0,0 +1,182 @@
+//===-- ExactColoring.cpp - Branch-and-bound coloring of small graphs -----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements ExactColoring, see ExactColoring.h.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ExactColoring.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include <algorithm>
+#include <map>
+
+using namespace llvm;
+
+ExactColoring::ExactColoring(std::vector<Node> Nodes, unsigned NumRegs)
+    : Nodes(std::move(Nodes)), BestCost(0), Found(false), Free(NumRegs),
+      Steps(0), OutOfTime(false) {
+  unsigned NumNodes = this->Nodes.size();
+  Decided.assign(NumNodes, false);
+  Color.assign(NumNodes, 0);
+  UseCount.assign(NumRegs, 0);
+
+  // the most constrained nodes first, the most expensive ones among them
+  for (unsigned i = 0; i != NumNodes; ++i)
+    Order.push_back(i);
+  std::stable_sort(Order.begin(), Order.end(), [this](unsigned A, unsigned B) {
+    const Node &NA = this->Nodes[A], &NB = this->Nodes[B];
+    if (NA.Neighbors.size() != NB.Neighbors.size())
+      return NA.Neighbors.size() > NB.Neighbors.size();
+    return NA.Weight > NB.Weight;
+  });
+
+  computeRegGroups(NumRegs);
+  computeCliques();
+}
+
+void ExactColoring::computeRegGroups(unsigned NumRegs) {
+  // the nodes each register is a candidate of
+  std::vector<std::vector<unsigned>> Users(NumRegs);
+  for (unsigned i = 0, e = Nodes.size(); i != e; ++i)
+    for (int Reg : Nodes[i].Colors)
+      Users[Reg].push_back(i);
+
+  std::map<std::vector<unsigned>, unsigned> Groups;
+  RegGroup.assign(NumRegs, 0);
+  for (unsigned Reg = 0; Reg != NumRegs; ++Reg)
+    if (!Users[Reg].empty())
+      RegGroup[Reg] = Groups.insert(std::make_pair(Users[Reg], Groups.size()))
+                          .first->second;
+}
+
+void ExactColoring::computeCliques() {
+  unsigned NumNodes = Nodes.size();
+  std::vector<BitVector> Adjacent(NumNodes, BitVector(NumNodes));
+  for (unsigned i = 0; i != NumNodes; ++i)
+    for (unsigned Neighbor : Nodes[i].Neighbors)
+      Adjacent[i].set(Neighbor);
+
+  // each node joins the first clique it is adjacent to all of, in search
+  // order, so the dense part of the graph ends up in the first cliques
+  for (unsigned N : Order) {
+    std::vector<unsigned> *Clique = nullptr;
+    for (std::vector<unsigned> &K : Cliques) {
+      if (all_of(K, [&](unsigned M) { return Adjacent[N].test(M); })) {
+        Clique = &K;
+        break;
+      }
+    }
+    if (!Clique) {
+      Cliques.emplace_back();
+      Clique = &Cliques.back();
+    }
+    Clique->push_back(N);
+  }
+}
+
+bool ExactColoring::isTakenByNeighbor(unsigned N, int Reg) const {
+  for (unsigned Neighbor : Nodes[N].Neighbors)
+    if (Decided[Neighbor] && Color[Neighbor] == Reg)
+      return true;
+  return false;
+}
+
+double ExactColoring::lowerBound() {
+  // The cliques are disjoint, so their bounds add up. In a clique, the
+  // undecided members need distinct registers among their candidates that no
+  // decided member holds: the ones in excess are uncolored, at best the
+  // cheapest ones.
+  double Bound = 0;
+  SmallVector<double, 16> Weights;
+  for (const std::vector<unsigned> &K : Cliques) {
+    Weights.clear();
+    Free.reset();
+    for (unsigned N : K) {
+      if (Decided[N])
+        continue;
+      Weights.push_back(Nodes[N].Weight);
+      for (int Reg : Nodes[N].Colors)
+        Free.set(Reg);
+    }
+    if (Weights.empty())
+      continue;
+    for (unsigned N : K)
+      if (Decided[N] && Color[N])
+        Free.reset(Color[N]);
+
+    unsigned NumFree = Free.count();
+    if (Weights.size() <= NumFree)
+      continue;
+    unsigned Excess = Weights.size() - NumFree;
+    std::partial_sort(Weights.begin(), Weights.begin() + Excess, Weights.end());
+    for (unsigned i = 0; i != Excess; ++i)
+      Bound += Weights[i];
+  }
+  return Bound;
+}
+
+void ExactColoring::search(unsigned Depth, double Cost) {
+  if ((++Steps & 1023) == 0 && std::chrono::steady_clock::now() > Deadline)
+    OutOfTime = true;
+  if (OutOfTime || Cost + lowerBound() >= BestCost)
+    return;
+
+  if (Depth == Order.size()) {
+    BestCost = Cost;
+    Best = Color;
+    Found = true;
+    return;
+  }
+
+  unsigned N = Order[Depth];
+  Decided[N] = true;
+
+  // only the first register of each group nobody holds yet: the others would
+  // give the same colorings with two registers swapped
+  SmallVector<unsigned, 8> TriedGroups;
+  for (int Reg : Nodes[N].Colors) {
+    if (isTakenByNeighbor(N, Reg))
+      continue;
+    if (UseCount[Reg] == 0) {
+      if (is_contained(TriedGroups, RegGroup[Reg]))
+        continue;
+      TriedGroups.push_back(RegGroup[Reg]);
+    }
+
+    Color[N] = Reg;
+    ++UseCount[Reg];
+    search(Depth + 1, Cost);
+    --UseCount[Reg];
+    if (OutOfTime)
+      break;
+  }
+
+  // leaving the node uncolored
+  Color[N] = 0;
+  if (!OutOfTime)
+    search(Depth + 1, Cost + Nodes[N].Weight);
+  Decided[N] = false;
+}
+
+ExactColoring::Result ExactColoring::solve(double UpperBound,
+                                           unsigned TimeLimitMs) {
+  BestCost = UpperBound;
+  Found = false;
+  OutOfTime = false;
+  Steps = 0;
+  Deadline = std::chrono::steady_clock::now() +
+             std::chrono::milliseconds(TimeLimitMs);
+
+  search(0, 0);
+
+  if (OutOfTime)
+    return TimedOut;
+  return Found ? Improved : NotImproved;
+}
@@ -0,0 +1,96 @@
+//===-- ExactColoring.h - Branch-and-bound coloring of small graphs -------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares ExactColoring, the minimum spill cost coloring used by
+// RAColorBasedCoalescing on small interference graphs (-color-exact-nodes).
+// Every node takes one of its candidate registers, different from the ones of
+// its neighbors, or is left uncolored at the price of its spill weight.
+//
+// The search is a depth-first branch and bound over the nodes by decreasing
+// degree. The lower bound comes from a greedy cover of the graph by cliques:
+// a clique with more uncolored members than free registers spills at least
+// the cheapest of them. Registers no node has taken yet are interchangeable
+// when the same nodes may use them, so only one of each such group is tried.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXACTCOLORING_H
+#define LLVM_EXACTCOLORING_H
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/Support/Compiler.h"
+#include <chrono>
+#include <vector>
+
+namespace llvm {
+
+class LLVM_LIBRARY_VISIBILITY ExactColoring {
+public:
+  struct Node {
+    /// Candidate registers, the preferred ones first.
+    std::vector<int> Colors;
+    /// Positions of the neighbors in the node list.
+    std::vector<unsigned> Neighbors;
+    /// Cost of leaving the node uncolored.
+    double Weight;
+  };
+
+  enum Result {
+    Improved,    ///< A cheaper coloring was found and proven optimal.
+    NotImproved, ///< No coloring is cheaper than the bound.
+    TimedOut     ///< The time limit was hit before the search ended.
+  };
+
+  ExactColoring(std::vector<Node> Nodes, unsigned NumRegs);
+
+  /// Search for the cheapest coloring costing less than UpperBound, for at
+  /// most TimeLimitMs milliseconds.
+  Result solve(double UpperBound, unsigned TimeLimitMs);
+
+  /// Register of node N in the coloring found by solve(), 0 if uncolored.
+  int getColor(unsigned N) const { return Best[N]; }
+
+private:
+  std::vector<Node> Nodes;
+
+  /// Nodes in search order, and the cliques covering them.
+  std::vector<unsigned> Order;
+  std::vector<std::vector<unsigned>> Cliques;
+
+  /// Group of each register: registers of one group are candidates of the
+  /// same nodes.
+  std::vector<unsigned> RegGroup;
+
+  /// Current partial coloring: whether each node is decided, its register
+  /// (0 if uncolored), and the number of nodes holding each register.
+  std::vector<bool> Decided;
+  std::vector<int> Color;
+  std::vector<unsigned> UseCount;
+
+  std::vector<int> Best;
+  double BestCost;
+  bool Found;
+
+  /// Scratch set of the registers free for a clique.
+  BitVector Free;
+
+  std::chrono::steady_clock::time_point Deadline;
+  unsigned Steps;
+  bool OutOfTime;
+
+  void computeRegGroups(unsigned NumRegs);
+  void computeCliques();
+  bool isTakenByNeighbor(unsigned N, int Reg) const;
+  double lowerBound();
+  void search(unsigned Depth, double Cost);
+};
+
+} // end namespace llvm
+
+#endif
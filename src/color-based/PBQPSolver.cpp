@@ -0,0 +1,213 @@
+//===-- PBQPSolver.cpp - Reduction solver for cost-matrix coloring --------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements PBQPSolver, see PBQPSolver.h.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PBQPSolver.h"
+#include "llvm/ADT/Statistic.h"
+#include <cassert>
+#include <limits>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "regalloc"
+
+STATISTIC(NumR0, "Number of PBQP nodes removed by R0");
+STATISTIC(NumRI, "Number of PBQP nodes removed by RI");
+STATISTIC(NumRII, "Number of PBQP nodes removed by RII");
+STATISTIC(NumRN, "Number of PBQP nodes fixed by the RN heuristic");
+
+PBQPSolver::Matrix PBQPSolver::Matrix::transpose() const {
+  Matrix T(Cols, Rows);
+  for (unsigned R = 0; R != Rows; ++R)
+    for (unsigned C = 0; C != Cols; ++C)
+      T.at(C, R) = at(R, C);
+  return T;
+}
+
+PBQPSolver::Matrix &PBQPSolver::Matrix::operator+=(const Matrix &Other) {
+  assert(Rows == Other.Rows && Cols == Other.Cols && "Matrix size mismatch");
+  for (unsigned i = 0, e = Cells.size(); i != e; ++i)
+    Cells[i] += Other.Cells[i];
+  return *this;
+}
+
+unsigned PBQPSolver::addNode(Vector Costs) {
+  Nodes.emplace_back();
+  Nodes.back().Costs = std::move(Costs);
+  Nodes.back().Bucket = 0;
+  return Nodes.size() - 1;
+}
+
+void PBQPSolver::addEdgeCosts(unsigned N1, unsigned N2, const Matrix &Costs) {
+  assert(N1 != N2 && "Edge of a node to itself");
+  assert(Costs.getRows() == Nodes[N1].Costs.size() &&
+         Costs.getCols() == Nodes[N2].Costs.size() && "Edge size mismatch");
+
+  std::map<unsigned, Matrix>::iterator I = Nodes[N1].Edges.find(N2);
+  if (I == Nodes[N1].Edges.end()) {
+    Nodes[N1].Edges.insert(std::make_pair(N2, Costs));
+    Nodes[N2].Edges.insert(std::make_pair(N1, Costs.transpose()));
+    return;
+  }
+  I->second += Costs;
+  Nodes[N2].Edges.find(N1)->second += Costs.transpose();
+}
+
+void PBQPSolver::updateBucket(unsigned N) {
+  unsigned Bucket = std::min<unsigned>(Nodes[N].Edges.size(), 3);
+  if (Bucket == Nodes[N].Bucket)
+    return;
+  Buckets[Nodes[N].Bucket].erase(N);
+  Buckets[Bucket].insert(N);
+  Nodes[N].Bucket = Bucket;
+}
+
+void PBQPSolver::remove(unsigned N, unsigned Fixed) {
+  Node &Nd = Nodes[N];
+  Removed R;
+  R.N = N;
+  R.Costs = Nd.Costs;
+  R.Fixed = Fixed;
+  for (const std::pair<const unsigned, Matrix> &E : Nd.Edges)
+    R.Edges.push_back(E);
+  Stack.push_back(std::move(R));
+
+  Buckets[Nd.Bucket].erase(N);
+  std::map<unsigned, Matrix> Edges;
+  Edges.swap(Nd.Edges);
+  for (const std::pair<const unsigned, Matrix> &E : Edges) {
+    Nodes[E.first].Edges.erase(N);
+    updateBucket(E.first);
+  }
+}
+
+// RI: the costs of N, at its best option for each option of its neighbor, are
+// added to the neighbor.
+void PBQPSolver::reduceI(unsigned N) {
+  const Vector &Costs = Nodes[N].Costs;
+  const std::pair<const unsigned, Matrix> &E = *Nodes[N].Edges.begin();
+  Vector &NeighborCosts = Nodes[E.first].Costs;
+
+  for (unsigned j = 0, e = NeighborCosts.size(); j != e; ++j) {
+    double Min = std::numeric_limits<double>::infinity();
+    for (unsigned i = 0, ie = Costs.size(); i != ie; ++i)
+      Min = std::min(Min, Costs[i] + E.second.at(i, j));
+    NeighborCosts[j] += Min;
+  }
+  ++NumRI;
+  remove(N, ~0u);
+}
+
+// RII: the same, for each pair of options of its two neighbors, on the edge
+// between them.
+void PBQPSolver::reduceII(unsigned N) {
+  const Vector &Costs = Nodes[N].Costs;
+  std::map<unsigned, Matrix>::const_iterator I = Nodes[N].Edges.begin();
+  unsigned V = I->first;
+  const Matrix &MV = I->second;
+  ++I;
+  unsigned W = I->first;
+  const Matrix &MW = I->second;
+
+  Matrix Folded(MV.getCols(), MW.getCols());
+  for (unsigned j = 0, je = MV.getCols(); j != je; ++j)
+    for (unsigned k = 0, ke = MW.getCols(); k != ke; ++k) {
+      double Min = std::numeric_limits<double>::infinity();
+      for (unsigned i = 0, ie = Costs.size(); i != ie; ++i)
+        Min = std::min(Min, Costs[i] + MV.at(i, j) + MW.at(i, k));
+      Folded.at(j, k) = Min;
+    }
+
+  addEdgeCosts(V, W, Folded);
+  ++NumRII;
+  remove(N, ~0u);
+}
+
+// RN: N takes the option that is best assuming the best option of each
+// neighbor, and the neighbors pay for it.
+void PBQPSolver::reduceN(unsigned N) {
+  const Node &Nd = Nodes[N];
+  unsigned Best = 0;
+  double BestCost = std::numeric_limits<double>::infinity();
+  for (unsigned i = 0, e = Nd.Costs.size(); i != e; ++i) {
+    double Cost = Nd.Costs[i];
+    for (const std::pair<const unsigned, Matrix> &E : Nd.Edges) {
+      double Min = std::numeric_limits<double>::infinity();
+      for (unsigned j = 0, je = E.second.getCols(); j != je; ++j)
+        Min = std::min(Min, E.second.at(i, j));
+      Cost += Min;
+    }
+    if (Cost < BestCost) {
+      BestCost = Cost;
+      Best = i;
+    }
+  }
+
+  for (const std::pair<const unsigned, Matrix> &E : Nd.Edges) {
+    Vector &NeighborCosts = Nodes[E.first].Costs;
+    for (unsigned j = 0, je = NeighborCosts.size(); j != je; ++j)
+      NeighborCosts[j] += E.second.at(Best, j);
+  }
+  ++NumRN;
+  remove(N, Best);
+}
+
+void PBQPSolver::solve() {
+  Buckets.assign(4, std::set<unsigned>());
+  for (unsigned N = 0, e = Nodes.size(); N != e; ++N) {
+    Nodes[N].Bucket = std::min<unsigned>(Nodes[N].Edges.size(), 3);
+    Buckets[Nodes[N].Bucket].insert(N);
+  }
+
+  while (true) {
+    if (!Buckets[0].empty()) {
+      ++NumR0;
+      remove(*Buckets[0].begin(), ~0u);
+    } else if (!Buckets[1].empty()) {
+      reduceI(*Buckets[1].begin());
+    } else if (!Buckets[2].empty()) {
+      reduceII(*Buckets[2].begin());
+    } else if (!Buckets[3].empty()) {
+      unsigned Max = *Buckets[3].begin();
+      for (unsigned N : Buckets[3])
+        if (Nodes[N].Edges.size() > Nodes[Max].Edges.size())
+          Max = N;
+      reduceN(Max);
+    } else {
+      break;
+    }
+  }
+
+  // Each node picks its best option given the neighbors removed after it,
+  // which are decided first.
+  Selection.assign(Nodes.size(), 0);
+  for (std::vector<Removed>::reverse_iterator I = Stack.rbegin(),
+       E = Stack.rend(); I != E; ++I) {
+    if (I->Fixed != ~0u) {
+      Selection[I->N] = I->Fixed;
+      continue;
+    }
+    unsigned Best = 0;
+    double BestCost = std::numeric_limits<double>::infinity();
+    for (unsigned i = 0, e = I->Costs.size(); i != e; ++i) {
+      double Cost = I->Costs[i];
+      for (const std::pair<unsigned, Matrix> &Edge : I->Edges)
+        Cost += Edge.second.at(i, Selection[Edge.first]);
+      if (Cost < BestCost) {
+        BestCost = Cost;
+        Best = i;
+      }
+    }
+    Selection[I->N] = Best;
+  }
+  Stack.clear();
+}
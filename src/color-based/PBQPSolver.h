@@ -0,0 +1,104 @@
+//===-- PBQPSolver.h - Reduction solver for cost-matrix coloring ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares PBQPSolver, the solver of the colorBased-pbqp allocator.
+// Each node has one cost per option (spilled, or one of its registers), each
+// edge a matrix with the cost of every pair of options of its two nodes, and
+// the solver picks one option per node minimizing the total cost.
+//
+// Nodes are removed by the reductions of Scholz and Eckstein: R0 (no edges),
+// RI (one edge, folded into the neighbor's costs) and RII (two edges, folded
+// into an edge between the two neighbors) are exact. When every node has three
+// edges or more, RN takes the node of highest degree, fixes its locally best
+// option and adds the matching row of each edge to its neighbors. The options
+// of the other nodes are chosen in reverse order of removal.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_PBQPSOLVER_H
+#define LLVM_PBQPSOLVER_H
+
+#include "llvm/Support/Compiler.h"
+#include <map>
+#include <set>
+#include <vector>
+
+namespace llvm {
+
+class LLVM_LIBRARY_VISIBILITY PBQPSolver {
+public:
+  typedef std::vector<double> Vector;
+
+  /// Costs of the option pairs of an edge, the options of its first node are
+  /// the rows.
+  class Matrix {
+    unsigned Rows, Cols;
+    std::vector<double> Cells;
+
+  public:
+    Matrix(unsigned Rows, unsigned Cols, double Init = 0)
+        : Rows(Rows), Cols(Cols), Cells(Rows * Cols, Init) {}
+
+    unsigned getRows() const { return Rows; }
+    unsigned getCols() const { return Cols; }
+
+    double &at(unsigned R, unsigned C) { return Cells[R * Cols + C]; }
+    double at(unsigned R, unsigned C) const { return Cells[R * Cols + C]; }
+
+    Matrix transpose() const;
+
+    Matrix &operator+=(const Matrix &Other);
+  };
+
+  /// Add a node with one cost per option, return its number.
+  unsigned addNode(Vector Costs);
+
+  /// Add Costs to the edge between N1 and N2, creating it if needed.
+  void addEdgeCosts(unsigned N1, unsigned N2, const Matrix &Costs);
+
+  /// Reduce the graph and select an option for every node.
+  void solve();
+
+  /// Option selected for node N.
+  unsigned getSelection(unsigned N) const { return Selection[N]; }
+
+private:
+  struct Node {
+    Vector Costs;
+    /// Edge matrices, indexed by neighbor, with the options of this node as
+    /// rows. Each edge is stored at both ends.
+    std::map<unsigned, Matrix> Edges;
+    /// Bucket the node is in: 0, 1 and 2 edges, or more (RN).
+    unsigned Bucket;
+  };
+
+  /// A removed node: its costs and edges at removal, and its option if RN
+  /// fixed it, ~0u otherwise.
+  struct Removed {
+    unsigned N;
+    Vector Costs;
+    std::vector<std::pair<unsigned, Matrix>> Edges;
+    unsigned Fixed;
+  };
+
+  std::vector<Node> Nodes;
+  std::vector<std::set<unsigned>> Buckets;
+  std::vector<Removed> Stack;
+  std::vector<unsigned> Selection;
+
+  void updateBucket(unsigned N);
+  void remove(unsigned N, unsigned Fixed);
+  void reduceI(unsigned N);
+  void reduceII(unsigned N);
+  void reduceN(unsigned N);
+};
+
+} // end namespace llvm
+
+#endif
@@ -0,0 +1,1273 @@
+//===-- RAColorBasedCoalescing.cpp - Color-based Coalescing Register Allocator ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the kernels shared by every strategy of the
+// RAColorBasedCoalescing function pass: the interference graph, the spill
+// costs, the extended colors and the assignment of the colors through
+// RegAllocBase. The strategies live in RAColorBasedOurs.cpp and
+// RAColorBasedOidara.cpp.
+//
+//===----------------------------------------------------------------------===//
+
+#include "RAColorBasedCoalescing.h"
+#include "ExactColoring.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/CodeGen/CalcSpillWeights.h"
+#include "llvm/CodeGen/LiveRangeEdit.h"
+#include "llvm/CodeGen/LiveRegMatrix.h"
+#include "llvm/CodeGen/LiveStackAnalysis.h"
+#include "llvm/CodeGen/MachineInstr.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/Passes.h"
+#include "llvm/CodeGen/VirtRegMap.h"
+#include "llvm/PassAnalysisSupport.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOpcodes.h"
+#include "llvm/Target/TargetRegisterInfo.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "regalloc"
+
+static cl::opt<bool> EnableSplit("color-split",
+                                 cl::desc("Split live ranges around single blocks before coloring"),
+                                 cl::init(false), cl::Hidden);
+
+static cl::opt<SplitEditor::ComplementSpillMode> SplitMode("color-split-mode",
+                                                          cl::desc("Spill mode of the complement interval after -color-split"),
+                                                          cl::values(clEnumValN(SplitEditor::SM_Partition, "partition", "no overlap, the default"),
+                                                                     clEnumValN(SplitEditor::SM_Size, "size", "hoist back-copies to minimize copies"),
+                                                                     clEnumValN(SplitEditor::SM_Speed, "speed", "hoist or remove back-copies to minimize copy frequency")),
+                                                          cl::init(SplitEditor::SM_Partition), cl::Hidden);
+
+static cl::opt<std::string> CacheDir("color-cache-dir",
+                                     cl::desc("Directory of the allocation cache (disabled if empty)"),
+                                     cl::init(""), cl::Hidden);
+
+static cl::opt<bool> EnableCallPreference("color-call-pref",
+                                          cl::desc("Prefer callee-saved colors for nodes live across calls, caller-saved ones otherwise"),
+                                          cl::init(true), cl::Hidden);
+
+enum SelectOrder { DegreeOrder, LoopOrder, FrequencyOrder };
+
+static cl::opt<SelectOrder> SelectOrderMode("color-select-order",
+                                            cl::desc("Order in which the nodes are colored"),
+                                            cl::values(clEnumValN(DegreeOrder, "degree", "highest degree first"),
+                                                       clEnumValN(LoopOrder, "loop", "deepest loop first, then highest spill cost"),
+                                                       clEnumValN(FrequencyOrder, "freq", "highest block-frequency weighted cost first")),
+                                            cl::init(DegreeOrder), cl::Hidden);
+
+static cl::opt<unsigned> ExactNodes("color-exact-nodes",
+                                    cl::desc("Color interference graphs of up to this many nodes exactly, by branch and bound (0 disables)"),
+                                    cl::init(0), cl::Hidden);
+
+static cl::opt<unsigned> ExactTimeLimit("color-exact-time",
+                                        cl::desc("Time limit of an exact coloring in milliseconds, the heuristic coloring is kept past it"),
+                                        cl::init(50), cl::Hidden);
+
+static cl::opt<bool> EnableSweep("color-sweep",
+                                 cl::desc("Color functions whose live intervals have one segment each by a sweep over their start points"),
+                                 cl::init(false), cl::Hidden);
+
+static cl::opt<unsigned> EvictCascade("color-evict-cascade",
+                                      cl::desc("Times a register can be evicted and requeued, its next eviction spills it"),
+                                      cl::init(3), cl::Hidden);
+
+static cl::opt<bool> EnableAffinity("color-affinity",
+                                    cl::desc("Prefer the free color of a copy or tied partner"),
+                                    cl::init(true), cl::Hidden);
+
+static cl::opt<bool> EnableSizePreference("color-size-pref",
+                                          cl::desc("On x86-64, weigh the REX prefixes a color costs the instructions of a node"),
+                                          cl::init(false), cl::Hidden);
+
+STATISTIC(SpillCost, "Spilled reads and writes weighted by block frequency");
+STATISTIC(NumCallCrossingPreserved, "Number of call-crossing nodes colored with a callee-saved register");
+STATISTIC(NumCallFreeVolatile, "Number of call-free nodes colored with a caller-saved register");
+STATISTIC(NumCalleeSavedUsed, "Number of callee-saved registers assigned (saved in the prologue)");
+STATISTIC(NumCacheHits, "Number of functions allocated from the cache");
+STATISTIC(NumCacheMisses, "Number of functions colored and added to the cache");
+STATISTIC(NumExactImproved, "Number of graphs whose exact coloring spills less than the heuristic");
+STATISTIC(NumExactOptimal, "Number of graphs whose heuristic coloring was proven optimal");
+STATISTIC(NumAffinityColors, "Number of nodes colored like a copy or tied partner");
+STATISTIC(NumRexAvoided, "Number of nodes kept off a register that needs a REX prefix");
+STATISTIC(NumEvicted, "Number of interferences evicted and requeued");
+STATISTIC(NumCascadeSpills, "Number of interferences spilled past -color-evict-cascade");
+STATISTIC(NumSwept, "Number of functions colored by the interval sweep");
+STATISTIC(NumExactTimeouts, "Number of exact colorings stopped by -color-exact-time");
+
+char RAColorBasedCoalescing::ID = 0;
+
+// Options that change the allocation of a function, part of the cache key.
+static std::string getOptionsKey() {
+  std::string Key;
+  raw_string_ostream OS(Key);
+  OS << "split=" << EnableSplit << ",splitmode=" << int(SplitMode)
+     << ",callpref=" << EnableCallPreference << ",order=" << int(SelectOrderMode)
+     << ",exact=" << ExactNodes << "/" << ExactTimeLimit << ",sweep=" << EnableSweep
+     << ",cascade=" << EvictCascade << ",affinity=" << EnableAffinity
+     << ",sizepref=" << EnableSizePreference;
+  return OS.str();
+}
+
+/// LLVM's own livedebugvars pass, looked up by name as its class is not
+/// exported, or null if it is not registered.
+static const PassInfo *getBuiltinDebugVars() {
+  return PassRegistry::getPassRegistry()->getPassInfo("livedebugvars");
+}
+
+/// Whether the private LiveDebugVariables copy is needed: only splitting
+/// has to move user variables to new registers, the built-in pass can't be
+/// told about them.
+static bool needsPrivateDebugVars() {
+  return EnableSplit || !getBuiltinDebugVars();
+}
+
+RAColorBasedCoalescing::RAColorBasedCoalescing(): MachineFunctionPass(ID) {
+  initializeLiveDebugVariablesPass(*PassRegistry::getPassRegistry());
+  initializeLiveIntervalsPass(*PassRegistry::getPassRegistry());
+  initializeSlotIndexesPass(*PassRegistry::getPassRegistry());
+  initializeRegisterCoalescerPass(*PassRegistry::getPassRegistry());
+  initializeMachineSchedulerPass(*PassRegistry::getPassRegistry());
+  initializeLiveStacksPass(*PassRegistry::getPassRegistry());
+  initializeMachineDominatorTreePass(*PassRegistry::getPassRegistry());
+  initializeMachineLoopInfoPass(*PassRegistry::getPassRegistry());
+  initializeVirtRegMapPass(*PassRegistry::getPassRegistry());
+  initializeLiveRegMatrixPass(*PassRegistry::getPassRegistry());
+}
+
+void RAColorBasedCoalescing::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.setPreservesCFG();
+  AU.addRequired<AAResultsWrapperPass>();
+  AU.addPreserved<AAResultsWrapperPass>();
+  AU.addRequired<LiveIntervals>();
+  AU.addPreserved<LiveIntervals>();
+  AU.addPreserved<SlotIndexes>();
+  // Without the private copy, the built-in analysis collects the debug values
+  // once before allocation and the rewriter emits them.
+  if (needsPrivateDebugVars()) {
+    AU.addRequired<LiveDebugVariables>();
+    AU.addPreserved<LiveDebugVariables>();
+  } else {
+    AU.addRequiredID(getBuiltinDebugVars()->getTypeInfo());
+    AU.addPreservedID(getBuiltinDebugVars()->getTypeInfo());
+  }
+  AU.addRequired<LiveStacks>();
+  AU.addPreserved<LiveStacks>();
+  AU.addRequired<MachineBlockFrequencyInfo>();
+  AU.addPreserved<MachineBlockFrequencyInfo>();
+  AU.addRequiredID(MachineDominatorsID);
+  AU.addPreservedID(MachineDominatorsID);
+  AU.addRequired<MachineLoopInfo>();
+  AU.addPreserved<MachineLoopInfo>();
+  AU.addRequired<VirtRegMap>();
+  AU.addPreserved<VirtRegMap>();
+  AU.addRequired<LiveRegMatrix>();
+  AU.addPreserved<LiveRegMatrix>();
+  MachineFunctionPass::getAnalysisUsage(AU);
+}
+
+void RAColorBasedCoalescing::releaseMemory() {
+  SpillerInstance.reset();
+  SE.reset();
+  // SA stays, cleared, so the next function reuses its buffers.
+  if (SA)
+    SA->clear();
+}
+
+unsigned RAColorBasedCoalescing::selectOrSplit(LiveInterval &VirtReg, SmallVectorImpl<unsigned> &SplitVRegs) {
+  // the matrix changed since the last call
+  UnitInterferences.clear();
+
+  if (Replaying) {
+    unsigned PhysReg;
+    if (replayDecision(VirtReg, SplitVRegs, PhysReg))
+      return PhysReg;
+
+    // The function diverged from its cached record, color what is left and
+    // continue as a cache miss.
+    Replaying = false;
+    algorithm(*MF);
+  }
+
+  // Populate a list of physical register spill candidates.
+  SmallVector<unsigned, 8> PhysRegSpillCands;
+
+  std::vector<int> potentialRegs = getAssignmentOrder(VirtReg);
+
+  // the register of the sweep first, whatever the order of the strategy
+  if (Swept) {
+    std::vector<int>::iterator swept = std::find(potentialRegs.begin(), potentialRegs.end(), ColorsTemp[VirtReg.reg]);
+    if (swept != potentialRegs.end())
+      std::rotate(potentialRegs.begin(), swept, swept + 1);
+  }
+
+  for (unsigned PhysReg: potentialRegs) {
+    // Check for interference in PhysReg
+    switch (Matrix->checkInterference(VirtReg, PhysReg)) {
+    case LiveRegMatrix::IK_Free:
+      // PhysReg is available, allocate it.
+      record(VirtReg.reg, AllocationCache::Assign, PhysReg);
+      return PhysReg;
+
+    case LiveRegMatrix::IK_VirtReg:
+      // Only virtual registers in the way, we may be able to spill them.
+      PhysRegSpillCands.push_back(PhysReg);
+      continue;
+
+    default:
+      // RegMask or RegUnit interference.
+      continue;
+    }
+  }
+
+  // Try to evict the cheapest interferences, if they weigh less than VirtReg.
+  if (unsigned PhysReg = tryEvict(VirtReg, PhysRegSpillCands, SplitVRegs)) {
+    assert(!Matrix->checkInterference(VirtReg, PhysReg) &&
+           "Interference after eviction.");
+    // Tell the caller to allocate to this newly freed physical register.
+    record(VirtReg.reg, AllocationCache::Requeue, PhysReg);
+    return PhysReg;
+  }
+
+  // No other spill candidates were found, so spill the current VirtReg.
+  // DEBUG(dbgs() << "spilling: " << VirtReg << '\n');
+  if (!VirtReg.isSpillable()) {
+    Cacheable = false;
+    return ~0u;
+  }
+  record(VirtReg.reg, AllocationCache::Spill, 0);
+  SpillCost += std::lround(getFrequencyWeightedCost(VirtReg.reg));
+  LiveRangeEdit LRE(&VirtReg, SplitVRegs, *MF, *LIS, VRM);
+  spiller().spill(LRE);
+
+  // The live virtual register requesting allocation was spilled, so tell
+  // the caller not to allocate anything during this round.
+  return 0;
+}
+
+const UnitInterference &RAColorBasedCoalescing::queryUnit(LiveInterval &VirtReg, unsigned Unit) {
+  std::pair<DenseMap<unsigned, UnitInterference>::iterator, bool> I =
+    UnitInterferences.insert(std::make_pair(Unit, UnitInterference()));
+  UnitInterference &UI = I.first->second;
+  if (!I.second)
+    return UI;
+
+  LiveIntervalUnion::Query &Q = Matrix->query(VirtReg, Unit);
+  Q.collectInterferingVRegs();
+  UI.Unspillable = Q.seenUnspillableVReg();
+  for (unsigned i = Q.interferingVRegs().size(); i; --i) {
+    LiveInterval *Intf = Q.interferingVRegs()[i - 1];
+    UI.VRegs.push_back(Intf);
+    if (!Intf->isSpillable())
+      UI.Unspillable = true;
+  }
+  return UI;
+}
+
+bool RAColorBasedCoalescing::getEvictionCost(LiveInterval &VirtReg, unsigned PhysReg, EvictionCost &Cost,
+                                             SmallVectorImpl<LiveInterval*> &Intfs) {
+  Cost = EvictionCost();
+  for (MCRegUnitIterator Units(PhysReg, TRI); Units.isValid(); ++Units) {
+    const UnitInterference &UI = queryUnit(VirtReg, *Units);
+    if (UI.Unspillable)
+      return false;
+    for (LiveInterval *Intf : UI.VRegs) {
+      // an interference may be seen on several units
+      if (is_contained(Intfs, Intf))
+        continue;
+      Intfs.push_back(Intf);
+      Cost.MaxWeight = std::max(Cost.MaxWeight, Intf->weight);
+      Cost.SumWeight += Intf->weight;
+    }
+  }
+  return true;
+}
+
+unsigned RAColorBasedCoalescing::tryEvict(LiveInterval &VirtReg, ArrayRef<unsigned> PhysRegCands,
+                                          SmallVectorImpl<unsigned> &SplitVRegs) {
+  unsigned BestPhysReg = 0;
+  EvictionCost BestCost;
+  SmallVector<LiveInterval*, 8> BestIntfs, Intfs;
+
+  for (unsigned PhysReg : PhysRegCands) {
+    EvictionCost Cost;
+    Intfs.clear();
+    if (!getEvictionCost(VirtReg, PhysReg, Cost, Intfs))
+      continue;
+    if (BestPhysReg && !(Cost < BestCost))
+      continue;
+    BestPhysReg = PhysReg;
+    BestCost = Cost;
+    BestIntfs.swap(Intfs);
+  }
+
+  // spilling VirtReg itself is cheaper
+  if (!BestPhysReg || !(BestCost.SumWeight < VirtReg.weight))
+    return 0;
+
+  evictInterferences(BestIntfs, SplitVRegs);
+  return BestPhysReg;
+}
+
+void RAColorBasedCoalescing::evictInterferences(ArrayRef<LiveInterval*> Intfs, SmallVectorImpl<unsigned> &SplitVRegs) {
+  UnitInterferences.clear();
+  for (LiveInterval *Intf : Intfs) {
+    // A LiveInterval instance may not be in a union during modification!
+    Matrix->unassign(*Intf);
+
+    // requeued, unless it was evicted too often already
+    if (++EvictCount[Intf->reg] <= EvictCascade) {
+      ++NumEvicted;
+      SplitVRegs.push_back(Intf->reg);
+      continue;
+    }
+
+    ++NumCascadeSpills;
+    SpillCost += std::lround(getFrequencyWeightedCost(Intf->reg));
+    LiveRangeEdit LRE(Intf, SplitVRegs, *MF, *LIS, VRM);
+    spiller().spill(LRE);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+//                    Coloring-Based Coalescing Methods                       //
+//===----------------------------------------------------------------------===//
+
+void RAColorBasedCoalescing::algorithm(MachineFunction &mf) {
+  buildInterferenceGraph();
+
+  calculateSpillCosts();
+
+  simplify();
+
+  biasedSelectExtended();
+
+  // printInterferenceGraphWithColor();
+}
+
+void RAColorBasedCoalescing::calculateSpillCosts() {
+  for(std::map<unsigned, std::set<unsigned>> :: iterator i = InterferenceGraph.begin(); i != InterferenceGraph.end(); i++) {
+    double newSpillWeight = 0;
+    unsigned vreg = i->first;
+
+    // go over the def-use of virtual register
+    for (MachineRegisterInfo::reg_instr_iterator I = MRI->reg_instr_begin(vreg), E = MRI->reg_instr_end(); I != E; ) {
+      MachineInstr *machInst = &*(I++);
+      unsigned loopDepth = MLI->getLoopDepth(machInst->getParent());
+
+      if (loopDepth > 35) {
+          loopDepth = 35; // Avoid overflowing the variable
+      }
+
+      std::pair<bool, bool> readWrite = machInst->readsWritesVirtualRegister(vreg);
+      newSpillWeight += (readWrite.first + readWrite.second) * pow(10, loopDepth);
+    }
+
+    SpillWeight[vreg] = newSpillWeight;
+  }
+}
+
+void RAColorBasedCoalescing::clear() {
+  InterferenceGraph.clear();
+  OnStack.clear();
+  ColorsTemp.clear();
+  Degree.clear();
+  ExtendedColors.clear();
+  SpillWeight.clear();
+  CrossesCall.clear();
+  SelectStack.clear();
+  CopyFrequency.clear();
+  Affinity.clear();
+  RexCost.clear();
+}
+
+void RAColorBasedCoalescing::clearAll() {
+  clear();
+  CopyRelated.clear();
+  Colors.clear();
+  EvictCount.clear();
+  Recorded.clear();
+  Replay.clear();
+}
+
+bool RAColorBasedCoalescing::isMarkedForSpill(unsigned vreg) {
+  return Colors[vreg] < 0;
+}
+
+double RAColorBasedCoalescing::getSelectPriority(unsigned vreg) {
+  switch (SelectOrderMode) {
+  case DegreeOrder:
+    return 0;
+
+  case LoopOrder: {
+    // the deepest loop the register is used in dominates, the spill cost
+    // (10^depth per access) orders the ranges of the same depth
+    unsigned maxDepth = 0;
+    for (MachineInstr &MI : MRI->reg_nodbg_instructions(vreg))
+      maxDepth = std::max(maxDepth, MLI->getLoopDepth(MI.getParent()));
+    return maxDepth * 1e12 + std::min(SpillWeight[vreg], 1e12 - 1);
+  }
+
+  case FrequencyOrder:
+    return getFrequencyWeightedCost(vreg);
+  }
+  llvm_unreachable("unknown select order");
+}
+
+double RAColorBasedCoalescing::getFrequencyWeightedCost(unsigned vreg) {
+  double cost = 0;
+  for (MachineInstr &MI : MRI->reg_nodbg_instructions(vreg)) {
+    std::pair<bool, bool> readWrite = MI.readsWritesVirtualRegister(vreg);
+    cost += (readWrite.first + readWrite.second) *
+            MBFI->getBlockFreqRelativeToEntryBlock(MI.getParent());
+  }
+  return cost;
+}
+
+// ===-------------- Interference Graph methods --------------===
+
+void RAColorBasedCoalescing::buildInterferenceGraph() {
+  for(unsigned i = 0, e = MRI->getNumVirtRegs(); i != e; ++i) {
+
+    //reg ID
+    unsigned Reg = TargetRegisterInfo::index2VirtReg(i);
+    if(MRI->reg_nodbg_empty(Reg)) {
+      continue;
+    }
+
+    //get the respective LiveInterval
+    LiveInterval *VirtReg = &LIS->getInterval(Reg);
+    unsigned vReg = VirtReg->reg;
+
+    // Ignores vReg if marked for spill
+    if (isMarkedForSpill(vReg)) {
+      continue;
+    }
+
+    OnStack[vReg] = false;
+    CrossesCall[vReg] = LIS->checkRegMaskInterference(*VirtReg, UsableRegs);
+
+    InterferenceGraph[vReg].insert(0);
+    InterferenceGraph[vReg].erase(0);
+
+    //For each vReg1
+    for(unsigned j = 0, r = MRI->getNumVirtRegs(); j != r; ++j) {
+      unsigned Reg1 = TargetRegisterInfo::index2VirtReg(j);
+      if(MRI->reg_nodbg_empty(Reg1)) {
+          continue;
+      }
+      LiveInterval *VirtReg1 = &LIS->getInterval(Reg1);
+      unsigned vReg1 = VirtReg1->reg;
+
+      //ignores if equal
+      if(VirtReg == VirtReg1) {
+        continue;
+      }
+
+      if (isMarkedForSpill(vReg1)) {
+        continue;
+      }
+
+      //if interference exists
+      if(VirtReg->overlaps(*VirtReg1)) {
+
+        // add edge vReg -> vReg1 on the interference graph
+        if(!InterferenceGraph[vReg].count(vReg1)) {
+          InterferenceGraph[vReg].insert(vReg1);
+          Degree[vReg]++;
+        }
+
+        // add edge vReg1 -> vReg on the interference graph
+        if(!InterferenceGraph[vReg1].count(vReg)) {
+          InterferenceGraph[vReg1].insert(vReg);
+          Degree[vReg1]++;
+        }
+      }
+    }
+  }
+}
+
+void RAColorBasedCoalescing::buildCopyRelated() {
+  CopyRelated.clear();
+  CopyFrequency.clear();
+
+  for (MachineBasicBlock &MBB : *MF) {
+    double freq = getInstrWeight(MBB);
+    for (MachineInstr &MI : MBB) {
+      if (!MI.isCopy() || MI.getOperand(0).getSubReg() || MI.getOperand(1).getSubReg())
+        continue;
+
+      unsigned dst = MI.getOperand(0).getReg();
+      unsigned src = MI.getOperand(1).getReg();
+      bool dstNode = InterferenceGraph.count(dst);
+      bool srcNode = InterferenceGraph.count(src);
+      if (dst == src || (!dstNode && !srcNode))
+        continue;
+
+      if (dstNode && srcNode) {
+        CopyRelated[dst].insert(src);
+        CopyRelated[src].insert(dst);
+      } else if (!TargetRegisterInfo::isPhysicalRegister(dstNode ? src : dst)) {
+        // a copy from a spilled node
+        continue;
+      }
+
+      CopyFrequency[std::make_pair(std::min(dst, src), std::max(dst, src))] += freq;
+    }
+  }
+}
+
+// A node and the registers it is copied to or from, or tied to by a two
+// address instruction, get the same color for free: the copy is removed by
+// the rewriter, the tied operand needs none.
+void RAColorBasedCoalescing::buildAffinities() {
+  Affinity.clear();
+
+  buildCopyRelated();
+  for (const std::pair<const std::pair<unsigned, unsigned>, double> &copy : CopyFrequency) {
+    unsigned first = copy.first.first, second = copy.first.second;
+    if (InterferenceGraph.count(first))
+      Affinity[first][second] += copy.second;
+    if (InterferenceGraph.count(second))
+      Affinity[second][first] += copy.second;
+  }
+
+  for (MachineBasicBlock &MBB : *MF) {
+    double freq = getInstrWeight(MBB);
+    for (MachineInstr &MI : MBB) {
+      for (unsigned i = 0, e = MI.getNumOperands(); i != e; ++i) {
+        const MachineOperand &use = MI.getOperand(i);
+        if (!use.isReg() || !use.isUse() || !use.isTied() || use.getSubReg())
+          continue;
+
+        const MachineOperand &def = MI.getOperand(MI.findTiedOperandIdx(i));
+        unsigned dst = def.getReg(), src = use.getReg();
+        if (def.getSubReg() || !dst || !src || dst == src)
+          continue;
+
+        if (InterferenceGraph.count(dst))
+          Affinity[dst][src] += freq;
+        if (InterferenceGraph.count(src))
+          Affinity[src][dst] += freq;
+      }
+    }
+  }
+}
+
+// On x86-64 an instruction needs a REX prefix to name a register of NeedsRex
+// in ModRM.reg, rm, the SIB base or index or the opcode: its explicit register
+// operands. The node costs a byte per instruction naming it there that would
+// not have the prefix anyway, either from another explicit operand already in
+// such a physical register or from REX.W, taken as an explicit register
+// operand outside the memory reference that is a 64-bit general purpose
+// register (this also takes the few instructions that default to 64 bits,
+// like PUSH64r, as prefixed already, and leaves them out). Target independent
+// instructions (COPY and the like) are left out, their encoding is only known
+// once they are lowered. VEX encoded instructions are counted as legacy ones.
+void RAColorBasedCoalescing::calculateEncodingCosts() {
+  RexCost.clear();
+  if (!EnableSizePreference || NeedsRex.none())
+    return;
+
+  SmallPtrSet<MachineInstr*, 16> Seen;
+  for(std::map<unsigned, std::set<unsigned>> :: iterator i = InterferenceGraph.begin(); i != InterferenceGraph.end(); i++) {
+    unsigned vreg = i->first;
+
+    double cost = 0;
+    Seen.clear();
+    for (MachineRegisterInfo::reg_nodbg_iterator I = MRI->reg_nodbg_begin(vreg), E = MRI->reg_nodbg_end(); I != E; ) {
+      MachineOperand &MO = *(I++);
+      MachineInstr *machInst = MO.getParent();
+      if (MO.isImplicit() || machInst->getOpcode() <= TargetOpcode::GENERIC_OP_END)
+        continue;
+      if (!Seen.insert(machInst).second)
+        continue;
+
+      const MCInstrDesc &desc = machInst->getDesc();
+      bool hasRex = false;
+      for (unsigned op = 0, e = machInst->getNumExplicitOperands(); op != e && !hasRex; ++op) {
+        const MachineOperand &Op = machInst->getOperand(op);
+        if (!Op.isReg() || !Op.getReg())
+          continue;
+        unsigned reg = Op.getReg();
+        if (TargetRegisterInfo::isPhysicalRegister(reg) && NeedsRex.test(reg))
+          hasRex = true;
+        else if (op < desc.getNumOperands() && desc.OpInfo[op].OperandType == MCOI::OPERAND_MEMORY)
+          continue;
+        else if (TargetRegisterInfo::isPhysicalRegister(reg))
+          hasRex = Rex64.test(reg);
+        else
+          hasRex = Rex64.test(*MRI->getRegClass(reg)->begin());
+      }
+      if (!hasRex)
+        cost += getInstrWeight(*machInst->getParent());
+    }
+
+    if (cost > 0)
+      RexCost[vreg] = cost;
+  }
+}
+
+// An instruction counts for its block frequency when optimizing for speed, and
+// once when optimizing for size.
+double RAColorBasedCoalescing::getInstrWeight(const MachineBasicBlock &MBB) {
+  if (MF->getFunction()->optForSize())
+    return 1;
+  return MBFI->getBlockFreqRelativeToEntryBlock(&MBB);
+}
+
+void RAColorBasedCoalescing::printInterferenceGraph() {
+  dbgs() << " Interference Graph: \n";
+  dbgs() << "-----------------------------------------------------------------\n";
+  for(std::map<unsigned, std::set<unsigned>> :: iterator j = InterferenceGraph.begin(); j != InterferenceGraph.end(); j++) {
+    dbgs() << "Interferences of " << j->first << "::" << PrintReg(j->first, TRI) << " => " << Degree[j->first] << ": {";
+    for(std::set<unsigned> :: iterator k = j->second.begin(); k != j->second.end(); k++) {
+      dbgs() << *k << ",";
+    }
+    dbgs() << "}\n";
+  }
+  dbgs() << "-----------------------------------------------------------------\n";
+}
+
+void RAColorBasedCoalescing::printInterferenceGraphWithColor() {
+  dbgs() << " Interference Graph: \n";
+  dbgs() << "-----------------------------------------------------------------\n";
+  for(std::map<unsigned, std::set<unsigned>> :: iterator j = InterferenceGraph.begin(); j != InterferenceGraph.end(); j++) {
+    dbgs() << "Interferences of " << j->first << "::" << PrintReg(j->first, TRI) << " => " << j->second.size() << ": {";
+    for(std::set<unsigned> :: iterator k = j->second.begin(); k != j->second.end(); k++) {
+      dbgs() << *k << ",";
+    }
+    dbgs() << "}";
+
+    int color = ColorsTemp[j->first];
+    if (isExtendedColor(color)) {
+      dbgs() << " -- EXTENDED COLOR => " << color << "\n";
+    } else {
+      dbgs() << " -- COLOR => " << color << "::" << PrintReg(color, TRI) << "\n";
+    }
+  }
+  dbgs() << "-----------------------------------------------------------------\n";
+}
+
+// ===-------------- Coloring methods --------------===
+
+void RAColorBasedCoalescing::biasedSelectExtended() {
+  if (EnableAffinity)
+    buildAffinities();
+  calculateEncodingCosts();
+
+  while(!SelectStack.empty()) {
+    unsigned vreg = SelectStack.back();
+    SelectStack.pop_back();
+
+    std::vector<int> potentialRegs = getPotentialRegs(vreg);
+
+    // the strategy picks among the preferred colors first
+    int color = COLOR_INVALID;
+    if (EnableCallPreference) {
+      color = getColor(getPreferredRegs(vreg, potentialRegs), vreg);
+
+      if (color != COLOR_INVALID) {
+        if (CrossesCall[vreg])
+          ++NumCallCrossingPreserved;
+        else
+          ++NumCallFreeVolatile;
+      }
+    }
+
+    if (color == COLOR_INVALID)
+      color = getColor(potentialRegs, vreg);
+
+    if (color == COLOR_INVALID) {
+      color = getColor(ExtendedColors, vreg);
+
+      if (color == COLOR_INVALID) {
+        color = createNewExtendedColor();
+      }
+    }
+
+    ColorsTemp[vreg] = color;
+  }
+
+  if (ExactNodes && !InterferenceGraph.empty() && InterferenceGraph.size() <= ExactNodes)
+    exactSelect();
+}
+
+void RAColorBasedCoalescing::exactSelect() {
+  // the spill cost of the heuristic coloring is the bound to beat
+  double heuristicCost = 0;
+  std::map<unsigned, unsigned> Index;
+  std::vector<unsigned> VRegs;
+  for(std::map<unsigned, std::set<unsigned>> :: iterator i = InterferenceGraph.begin(); i != InterferenceGraph.end(); i++) {
+    unsigned vreg = i->first;
+    Index[vreg] = VRegs.size();
+    VRegs.push_back(vreg);
+    if (isExtendedColor(ColorsTemp[vreg]))
+      heuristicCost += SpillWeight[vreg];
+  }
+  if (heuristicCost == 0)
+    return;
+
+  std::vector<ExactColoring::Node> Nodes(VRegs.size());
+  for (unsigned i = 0, e = VRegs.size(); i != e; ++i) {
+    unsigned vreg = VRegs[i];
+    ExactColoring::Node &N = Nodes[i];
+
+    // the preferred colors are tried first, so they win among equal costs
+    std::vector<int> potentialRegs = getPotentialRegs(vreg);
+    if (EnableCallPreference) {
+      N.Colors = getPreferredRegs(vreg, potentialRegs);
+      for (int physReg : potentialRegs)
+        if (CalleeSaved.test(physReg) != CrossesCall[vreg])
+          N.Colors.push_back(physReg);
+    } else {
+      N.Colors = potentialRegs;
+    }
+
+    for (unsigned neighbor : InterferenceGraph[vreg])
+      N.Neighbors.push_back(Index[neighbor]);
+    N.Weight = SpillWeight[vreg];
+  }
+
+  ExactColoring Search(std::move(Nodes), TRI->getNumRegs());
+  switch (Search.solve(heuristicCost, ExactTimeLimit)) {
+  case ExactColoring::TimedOut:
+    ++NumExactTimeouts;
+    return;
+  case ExactColoring::NotImproved:
+    ++NumExactOptimal;
+    return;
+  case ExactColoring::Improved:
+    ++NumExactImproved;
+    break;
+  }
+
+  // the uncolored nodes take extended colors as in biasedSelectExtended(),
+  // once every register is in place
+  ExtendedColors.clear();
+  for (unsigned i = 0, e = VRegs.size(); i != e; ++i)
+    ColorsTemp[VRegs[i]] = Search.getColor(i) ? Search.getColor(i) : COLOR_INVALID;
+
+  for (unsigned i = 0, e = VRegs.size(); i != e; ++i) {
+    unsigned vreg = VRegs[i];
+    if (ColorsTemp[vreg] != COLOR_INVALID)
+      continue;
+
+    int color = getColor(ExtendedColors, vreg);
+    if (color == COLOR_INVALID)
+      color = createNewExtendedColor();
+    ColorsTemp[vreg] = color;
+  }
+}
+
+std::vector<int> RAColorBasedCoalescing::getPotentialRegs(unsigned vreg) {
+  std::vector<int> potentialRegs;
+
+  AllocationOrder Order(vreg, *VRM, RegClassInfo, Matrix);
+  while (unsigned physReg = Order.next()) {
+    potentialRegs.push_back(physReg);
+  }
+
+  return potentialRegs;
+}
+
+// A node live across a call prefers callee-saved registers, which the call
+// preserves, over being spilled around the call. A node that is not prefers
+// caller-saved registers, which cost no save and restore in the prologue.
+const std::vector<int> &RAColorBasedCoalescing::getPreferredRegs(unsigned vreg, const std::vector<int> &potentialRegs) {
+  bool crossesCall = CrossesCall[vreg];
+
+  PreferredRegs.clear();
+  for (int physReg : potentialRegs)
+    if (CalleeSaved.test(physReg) == crossesCall)
+      PreferredRegs.push_back(physReg);
+
+  return PreferredRegs;
+}
+
+std::vector<int> RAColorBasedCoalescing::getAssignmentOrder(LiveInterval &VirtReg) {
+  return getPotentialRegs(VirtReg.reg);
+}
+
+int RAColorBasedCoalescing::createNewExtendedColor() {
+  int new_color;
+  if (ExtendedColors.empty()) {
+    new_color = -1;
+  } else {
+    new_color = ExtendedColors.back() - 1;
+  }
+
+  ExtendedColors.push_back(new_color);
+
+  return new_color;
+}
+
+bool RAColorBasedCoalescing::isExtendedColor(int color) {
+  return color < 0;
+}
+
+int RAColorBasedCoalescing::pickFreeColor(const std::vector<int> &Colors, unsigned vreg,
+                                          function_ref<unsigned(unsigned)> Choose) {
+  for (unsigned i = 0, e = Colors.size(); i != e; ++i)
+    if (!isExtendedColor(Colors[i]))
+      ColorSlot[Colors[i]] = i;
+
+  // The list holds at most the allocatable registers of one class, or the
+  // extended colors, so one or two words cover every target we run on.
+  int color;
+  if (Colors.size() <= 64)
+    color = pickFreeColorIn<FixedColorSet<64>>(Colors, vreg, Choose);
+  else if (Colors.size() <= 128)
+    color = pickFreeColorIn<FixedColorSet<128>>(Colors, vreg, Choose);
+  else
+    color = pickFreeColorIn<DynamicColorSet>(Colors, vreg, Choose);
+
+  for (int c : Colors)
+    if (!isExtendedColor(c))
+      ColorSlot[c] = -1;
+  return color;
+}
+
+template <class ColorSetT>
+int RAColorBasedCoalescing::pickFreeColorIn(const std::vector<int> &Colors, unsigned vreg,
+                                            function_ref<unsigned(unsigned)> Choose) {
+  ColorSetT Taken(Colors.size());
+
+  for (unsigned neighbor : InterferenceGraph[vreg]) {
+    std::map<unsigned, int>::const_iterator c = ColorsTemp.find(neighbor);
+    if (c == ColorsTemp.end() || c->second == COLOR_INVALID)
+      continue;
+
+    // extended colors are kept in order, -1 at position 0
+    int slot;
+    if (isExtendedColor(c->second)) {
+      unsigned idx = -c->second - 1;
+      slot = idx < Colors.size() && Colors[idx] == c->second ? idx : -1;
+    } else {
+      slot = ColorSlot[c->second];
+    }
+
+    if (slot >= 0)
+      Taken.set(slot);
+  }
+
+  unsigned numFree = Taken.countFree();
+  if (numFree == 0)
+    return COLOR_INVALID;
+
+  std::map<unsigned, std::map<unsigned, double>>::const_iterator partners = Affinity.find(vreg);
+  std::map<unsigned, double>::const_iterator rex = RexCost.find(vreg);
+  if (partners == Affinity.end() && rex == RexCost.end())
+    return Colors[Taken.findFree(Choose(numFree))];
+
+  // Each free color is scored by the copies and tied operands its partners
+  // save, less the REX prefixes it costs, a byte being a third of a register
+  // copy. The strategy only breaks ties among the best ones.
+  AffinityScore.assign(Colors.size(), 0);
+  if (partners != Affinity.end()) {
+    for (const std::pair<const unsigned, double> &partner : partners->second) {
+      int color = partner.first;
+      if (!TargetRegisterInfo::isPhysicalRegister(partner.first)) {
+        std::map<unsigned, int>::const_iterator c = ColorsTemp.find(partner.first);
+        if (c == ColorsTemp.end())
+          continue;
+        color = c->second;
+      }
+
+      if (color > 0 && ColorSlot[color] >= 0)
+        AffinityScore[ColorSlot[color]] += partner.second;
+    }
+  }
+  if (rex != RexCost.end()) {
+    for (unsigned i = 0, e = Colors.size(); i != e; ++i)
+      if (!isExtendedColor(Colors[i]) && NeedsRex.test(Colors[i]))
+        AffinityScore[i] -= rex->second / 3;
+  }
+
+  SmallVector<unsigned, 32> bestSlots;
+  double best = 0;
+  for (unsigned i = 0; i != numFree; ++i) {
+    unsigned slot = Taken.findFree(i);
+    if (!bestSlots.empty() && AffinityScore[slot] < best)
+      continue;
+    if (bestSlots.empty() || AffinityScore[slot] > best)
+      bestSlots.clear();
+    best = AffinityScore[slot];
+    bestSlots.push_back(slot);
+  }
+
+  unsigned slot = bestSlots[Choose(bestSlots.size())];
+  if (partners != Affinity.end() && best > 0)
+    ++NumAffinityColors;
+  if (rex != RexCost.end() && bestSlots.size() < numFree && !isExtendedColor(Colors[slot]) &&
+      !NeedsRex.test(Colors[slot]))
+    ++NumRexAvoided;
+  return Colors[slot];
+}
+
+// When every live interval is a single segment, the interference graph is an
+// interval graph: a sweep over the start points, giving each interval a
+// register no active interval overlaps, colors it with as few registers as
+// possible. Without a free register, the interval that ends the furthest per
+// unit of spill weight, the current one included, gives up its register.
+// Registers the matrix already reports interference on, fixed registers and
+// regmasks, are never given; if that leaves an interval without a candidate,
+// the sweep gives up and the strategy colors the function.
+bool RAColorBasedCoalescing::sweepColor() {
+  std::vector<std::pair<SlotIndex, unsigned>> Starts;
+  for (unsigned i = 0, e = MRI->getNumVirtRegs(); i != e; ++i) {
+    unsigned vreg = TargetRegisterInfo::index2VirtReg(i);
+    if (MRI->reg_nodbg_empty(vreg))
+      continue;
+
+    // a hole, or a value live around a loop or into two successors, makes
+    // more than one segment
+    LiveInterval &LI = LIS->getInterval(vreg);
+    if (LI.empty())
+      continue;
+    if (LI.size() != 1)
+      return false;
+    Starts.push_back(std::make_pair(LI.beginIndex(), vreg));
+  }
+  std::sort(Starts.begin(), Starts.end());
+
+  // intervals holding a register, by end point, and the units of their
+  // registers
+  std::set<std::pair<SlotIndex, unsigned>> Active;
+  BitVector UnitsUsed(TRI->getNumRegUnits());
+
+  auto isFree = [&](int physReg) {
+    for (MCRegUnitIterator Units(physReg, TRI); Units.isValid(); ++Units)
+      if (UnitsUsed.test(*Units))
+        return false;
+    return true;
+  };
+  auto setUsed = [&](int physReg, bool used) {
+    for (MCRegUnitIterator Units(physReg, TRI); Units.isValid(); ++Units)
+      UnitsUsed[*Units] = used;
+  };
+
+  for (const std::pair<SlotIndex, unsigned> &S : Starts) {
+    SlotIndex start = S.first;
+    unsigned vreg = S.second;
+    LiveInterval &LI = LIS->getInterval(vreg);
+
+    while (!Active.empty() && Active.begin()->first <= start) {
+      setUsed(ColorsTemp[Active.begin()->second], false);
+      Active.erase(Active.begin());
+    }
+
+    std::vector<int> potentialRegs;
+    for (int physReg : getPotentialRegs(vreg))
+      if (Matrix->checkInterference(LI, physReg) == LiveRegMatrix::IK_Free)
+        potentialRegs.push_back(physReg);
+    if (potentialRegs.empty()) {
+      ColorsTemp.clear();
+      ExtendedColors.clear();
+      return false;
+    }
+
+    int color = COLOR_INVALID;
+    for (int physReg : potentialRegs) {
+      if (isFree(physReg)) {
+        color = physReg;
+        break;
+      }
+    }
+
+    if (color == COLOR_INVALID) {
+      // the active registers never overlap, so the one of the victim is free
+      // once it is released
+      double worst = start.distance(LI.endIndex()) / LI.weight;
+      std::pair<SlotIndex, unsigned> victim(LI.endIndex(), vreg);
+      for (const std::pair<SlotIndex, unsigned> &A : Active) {
+        if (std::find(potentialRegs.begin(), potentialRegs.end(), ColorsTemp[A.second]) == potentialRegs.end())
+          continue;
+        double score = start.distance(A.first) / LIS->getInterval(A.second).weight;
+        if (score > worst) {
+          worst = score;
+          victim = A;
+        }
+      }
+
+      if (victim.second != vreg) {
+        color = ColorsTemp[victim.second];
+        setUsed(color, false);
+        Active.erase(victim);
+        ColorsTemp[victim.second] = createNewExtendedColor();
+      }
+    }
+
+    if (color == COLOR_INVALID) {
+      ColorsTemp[vreg] = createNewExtendedColor();
+      continue;
+    }
+
+    ColorsTemp[vreg] = color;
+    setUsed(color, true);
+    Active.insert(std::make_pair(LI.endIndex(), vreg));
+  }
+
+  ++NumSwept;
+  return true;
+}
+
+// ===-------------- LLVM --------------===
+
+bool RAColorBasedCoalescing::runOnMachineFunction(MachineFunction &mf) {
+  /*dbgs() << "\n********** COLORING-BASED COALESCING REGISTER ALLOCATION **********\n"
+              << "********** Function: "
+              << mf.getName() << '\n';*/
+
+  MF = &mf;
+  RegAllocBase::init(getAnalysis<VirtRegMap>(),
+                     getAnalysis<LiveIntervals>(),
+                     getAnalysis<LiveRegMatrix>());
+
+  MBFI = &getAnalysis<MachineBlockFrequencyInfo>();
+  DomTree = &getAnalysis<MachineDominatorTree>();
+
+  ColorSlot.assign(TRI->getNumRegs(), -1);
+
+  CalleeSaved.clear();
+  CalleeSaved.resize(TRI->getNumRegs());
+  for (const MCPhysReg *CSR = TRI->getCalleeSavedRegs(MF); *CSR; ++CSR)
+    for (MCSubRegIterator SubReg(*CSR, TRI, /*IncludeSelf=*/true); SubReg.isValid(); ++SubReg)
+      CalleeSaved.set(*SubReg);
+
+  // the registers of x86-64 whose encoding needs a REX prefix: r8-r15,
+  // xmm8-xmm15 and up, and the low bytes of sp, bp, si and di, which share
+  // their encoding with a wider register (ah-bh share theirs with none);
+  // the 64-bit general purpose registers are the ones with a 32-bit
+  // sub-register
+  NeedsRex.clear();
+  NeedsRex.resize(TRI->getNumRegs());
+  Rex64.clear();
+  Rex64.resize(TRI->getNumRegs());
+  if (MF->getTarget().getTargetTriple().getArch() == Triple::x86_64) {
+    for (unsigned Reg = 1, e = TRI->getNumRegs(); Reg != e; ++Reg) {
+      unsigned encoding = TRI->getEncodingValue(Reg);
+      if (encoding >= 8)
+        NeedsRex.set(Reg);
+      for (MCSuperRegIterator Super(Reg, TRI); Super.isValid(); ++Super)
+        if (encoding >= 4 && TRI->getEncodingValue(*Super) == encoding &&
+            TRI->getSubRegIdxSize(TRI->getSubRegIndex(*Super, Reg)) == 8)
+          NeedsRex.set(Reg);
+      for (MCSubRegIndexIterator Sub(Reg, TRI); Sub.isValid(); ++Sub)
+        if (TRI->getSubRegIdxSize(Sub.getSubRegIndex()) == 32)
+          Rex64.set(Reg);
+    }
+  }
+
+
+  calculateSpillWeightsAndHints(*LIS, *MF, VRM,
+                                getAnalysis<MachineLoopInfo>(),
+                                getAnalysis<MachineBlockFrequencyInfo>());
+
+  SpillerInstance.reset(createInlineSpiller(*this, *MF, *VRM));
+
+  MLI = &getAnalysis<MachineLoopInfo>();
+  DebugVars = needsPrivateDebugVars() ? &getAnalysis<LiveDebugVariables>()
+                                      : nullptr;
+  AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
+
+  std::unique_ptr<SplitAnalysis> NewSA(new SplitAnalysis(*VRM, *LIS, *MLI));
+  if (SA)
+    NewSA->reuseBuffers(*SA);
+  SA = std::move(NewSA);
+  SE.reset(new SplitEditor(*SA, *AA, *LIS, *VRM, *DomTree, *MBFI));
+
+  // The key is taken before splitting, which is deterministic.
+  AllocationCache *Cache = nullptr;
+  AllocationCache::Key CacheKey;
+  Replaying = false;
+  Cacheable = true;
+  ReplayPos = 0;
+  if (!CacheDir.empty()) {
+    Cache = &AllocationCache::get(CacheDir);
+    CacheKey = AllocationCache::computeKey(mf, getStrategyName(), getOptionsKey());
+    Replaying = Cache->lookup(CacheKey, Replay);
+  }
+
+  if (EnableSplit)
+    trySplitAll();
+
+
+  // dbgs() << "********** Number of virtual registers: " << MRI->getNumVirtRegs() << "\n\n";
+
+  // printVirtualRegisters();
+
+  Swept = false;
+  if (!Replaying) {
+    if (EnableSweep && sweepColor())
+      Swept = true;
+    else
+      algorithm(mf);
+  }
+
+  allocatePhysRegs();
+  postOptimization();
+
+  // The private copy took the DBG_VALUEs out, put them back in their final
+  // locations before the rewriter runs.
+  if (DebugVars)
+    DebugVars->emitDebugValues(VRM);
+
+  for (const MCPhysReg *CSR = TRI->getCalleeSavedRegs(MF); *CSR; ++CSR)
+    if (Matrix->isPhysRegUsed(*CSR))
+      ++NumCalleeSavedUsed;
+
+  if (Cache) {
+    if (Replaying && ReplayPos == Replay.size()) {
+      ++NumCacheHits;
+    } else if (Cacheable) {
+      ++NumCacheMisses;
+      Cache->insert(CacheKey, Recorded);
+    }
+  }
+
+  clearAll();
+
+  // Diagnostic output before rewriting
+  // dbgs() << "\nPost alloc VirtRegMap:\n" << *VRM << "\n";
+
+  releaseMemory();
+  return true;
+}
+
+void RAColorBasedCoalescing::printVirtualRegisters() {
+  dbgs() << " Virtual Registers: \n";
+  dbgs() << "-----------------------------------------------------------------\n";
+  for (unsigned i = 0, e = MRI->getNumVirtRegs(); i != e; ++i) {
+    unsigned Reg = TargetRegisterInfo::index2VirtReg(i);
+    if (MRI->reg_nodbg_empty(Reg))
+      continue;
+    LiveInterval *VirtReg = &LIS->getInterval(Reg);
+    dbgs() << *VirtReg << "::" << Reg <<'\n';
+  }
+  dbgs() << "-----------------------------------------------------------------\n\n";
+}
+
+// ===-------------- Allocation cache --------------===
+
+void RAColorBasedCoalescing::record(unsigned VirtReg, uint32_t Kind, unsigned PhysReg) {
+  if (CacheDir.empty())
+    return;
+  AllocationCache::Decision D = { VirtReg, Kind, PhysReg };
+  Recorded.push_back(D);
+}
+
+// Apply the next cached decision to VirtReg, checking it against the
+// LiveRegMatrix first. Returns false, changing nothing, when the decision
+// does not apply to the function as it is now.
+bool RAColorBasedCoalescing::replayDecision(LiveInterval &VirtReg, SmallVectorImpl<unsigned> &SplitVRegs, unsigned &PhysReg) {
+  if (ReplayPos == Replay.size())
+    return false;
+  const AllocationCache::Decision &D = Replay[ReplayPos];
+  if (D.VirtReg != VirtReg.reg)
+    return false;
+
+  if (D.Kind == AllocationCache::Spill) {
+    if (!VirtReg.isSpillable())
+      return false;
+    ++ReplayPos;
+    record(D.VirtReg, D.Kind, D.PhysReg);
+    SpillCost += std::lround(getFrequencyWeightedCost(VirtReg.reg));
+    LiveRangeEdit LRE(&VirtReg, SplitVRegs, *MF, *LIS, VRM);
+    spiller().spill(LRE);
+    PhysReg = 0;
+    return true;
+  }
+
+  const TargetRegisterClass *RC = MRI->getRegClass(VirtReg.reg);
+  if (!RC->contains(D.PhysReg) || MRI->isReserved(D.PhysReg))
+    return false;
+
+  LiveRegMatrix::InterferenceKind IK = Matrix->checkInterference(VirtReg, D.PhysReg);
+  if (D.Kind == AllocationCache::Assign) {
+    if (IK != LiveRegMatrix::IK_Free)
+      return false;
+  } else if (D.Kind == AllocationCache::Requeue) {
+    EvictionCost Cost;
+    SmallVector<LiveInterval*, 8> Intfs;
+    if (IK != LiveRegMatrix::IK_VirtReg || !getEvictionCost(VirtReg, D.PhysReg, Cost, Intfs))
+      return false;
+    evictInterferences(Intfs, SplitVRegs);
+  } else {
+    return false;
+  }
+
+  ++ReplayPos;
+  record(D.VirtReg, D.Kind, D.PhysReg);
+  PhysReg = D.PhysReg;
+  return true;
+}
+
+// ===-------------- Spliting --------------===
+
+void RAColorBasedCoalescing::trySplitAll() {
+  typedef SmallVector<unsigned, 4> VirtRegVec;
+
+  for (unsigned i = 0, e = MRI->getNumVirtRegs(); i != e; ++i) {
+    // reg ID
+    unsigned Reg = TargetRegisterInfo::index2VirtReg(i);
+    // if is not a DEBUG register
+    if (MRI->reg_nodbg_empty(Reg))
+      continue;
+
+    LiveInterval *VirtReg = &LIS->getInterval(Reg);
+    VirtRegVec SplitVRegs;
+    AllocationOrder Order(VirtReg->reg, *VRM, RegClassInfo, Matrix);
+
+    trySplit(*VirtReg, Order, SplitVRegs);
+  }
+
+  // Rewrite the debug variable locations while the new intervals are intact.
+  DebugVars->flushSplits();
+}
+
+unsigned RAColorBasedCoalescing::trySplit(LiveInterval &VirtReg, AllocationOrder &Order, SmallVectorImpl<unsigned> &NewVRegs) {
+  SA->analyze(&VirtReg);
+  assert(&SA->getParent() == &VirtReg && "Live range wasn't analyzed");
+  unsigned Reg = VirtReg.reg;
+  bool SingleInstrs = RegClassInfo.isProperSubClass(MRI->getRegClass(Reg));
+  LiveRangeEdit LREdit(&VirtReg, NewVRegs, *MF, *LIS, VRM, nullptr);
+  SE->reset(LREdit, SplitMode);
+  ArrayRef<SplitAnalysis::BlockInfo> UseBlocks = SA->getUseBlocks();
+
+  for (unsigned i = 0; i != UseBlocks.size(); ++i) {
+    const SplitAnalysis::BlockInfo &BI = UseBlocks[i];
+    if (SA->shouldSplitSingleBlock(BI, SingleInstrs)) {
+      SE->splitSingleBlock(BI);
+    }
+  }
+  // No blocks were split.
+  if (LREdit.empty())
+    return 0;
+
+  // We did split for some blocks.
+  SmallVector<unsigned, 8> IntvMap;
+  SE->finish(&IntvMap);
+
+  // Tell LiveDebugVariables about the new ranges, if it tracks any variable.
+  // trySplitAll applies them all at once.
+  if (!DebugVars->empty())
+    DebugVars->deferSplitRegister(Reg, LREdit.regs());
+
+  return 0;
+}
@@ -0,0 +1,338 @@
+//===-- RAColorBasedCoalescing.h - Color-based Coalescing Register Allocator ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the RAColorBasedCoalescing function pass, the common base
+// of the coloring-based coalescing register allocators. It owns the shared
+// kernels (interference graph, spill costs, extended colors and the final
+// assignment driven by RegAllocBase), while each strategy decides how the
+// graph is simplified, which color is picked for a node, and in which order
+// the physical registers are tried during assignment.
+//
+// Strategies register themselves with RegisterRegAlloc in their own file:
+//   colorBased-ours    RAColorBasedOurs.cpp
+//   colorBased-oidara  RAColorBasedOidara.cpp
+//   colorBased-pbqp    RAColorBasedPBQP.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_RACOLORBASEDCOALESCING_H
+#define LLVM_RACOLORBASEDCOALESCING_H
+
+#include "AllocationCache.h"
+#include "ColorSet.h"
+#include "CodeGen/AllocationOrder.h"
+#include "CodeGen/LiveDebugVariables.h"
+#include "CodeGen/RegAllocBase.h"
+#include "CodeGen/Spiller.h"
+#include "CodeGen/SplitKit.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/CodeGen/LiveIntervalAnalysis.h"
+#include "llvm/CodeGen/LiveRangeEdit.h"
+#include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
+#include "llvm/CodeGen/MachineDominators.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineLoopInfo.h"
+#include <map>
+#include <memory>
+#include <queue>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#define COLOR_INVALID 0
+
+namespace llvm {
+
+/// Cost of evicting the virtual registers assigned to a physical register: the
+/// largest and the summed spill weight.
+struct EvictionCost {
+  float MaxWeight;
+  float SumWeight;
+
+  EvictionCost() : MaxWeight(0), SumWeight(0) {}
+
+  bool operator<(const EvictionCost &O) const {
+    return std::tie(SumWeight, MaxWeight) < std::tie(O.SumWeight, O.MaxWeight);
+  }
+};
+
+/// Interferences of the virtual register being allocated on one register unit.
+struct UnitInterference {
+  SmallVector<LiveInterval*, 4> VRegs;
+  bool Unspillable;
+
+  UnitInterference() : Unspillable(false) {}
+};
+
+struct CompSpillWeight {
+  bool operator()(LiveInterval *A, LiveInterval *B) const {
+    return A->weight < B->weight;
+  }
+};
+
+class LLVM_LIBRARY_VISIBILITY RAColorBasedCoalescing : public MachineFunctionPass,
+                                                       public RegAllocBase {
+  protected:
+    // context
+    MachineFunction *MF;
+
+    //LLVM
+    MachineBlockFrequencyInfo *MBFI;
+    MachineDominatorTree *DomTree;
+    MachineLoopInfo *MLI;
+    LiveDebugVariables *DebugVars;
+    AliasAnalysis *AA;
+
+    std::unique_ptr<SplitAnalysis> SA;
+    std::unique_ptr<SplitEditor> SE;
+
+    // state
+    std::unique_ptr<Spiller> SpillerInstance;
+    std::priority_queue<LiveInterval*, std::vector<LiveInterval*>,
+                        CompSpillWeight> Queue;
+
+    // Scratch space.  Allocated here to avoid repeated malloc calls in
+    // selectOrSplit().
+    BitVector UsableRegs;
+
+    // Graph Coloring
+    std::map<unsigned, std::set<unsigned>> InterferenceGraph;
+    std::map<unsigned, int> Degree;
+    std::map<unsigned, bool> OnStack;
+    std::map<unsigned, int> ColorsTemp;
+    std::map<unsigned, int> Colors;
+    std::map<unsigned, std::set<unsigned>> CopyRelated;
+
+    // Frequency of the full copies between two registers, one of them at least
+    // a node of the graph, see getInstrWeight(). Pairs are in increasing order,
+    // so a physical register comes first. Filled by buildCopyRelated().
+    std::map<std::pair<unsigned, unsigned>, double> CopyFrequency;
+    // Frequency of the copies and tied operands between a node and each of
+    // its partners, virtual or physical. Filled by buildAffinities().
+    std::map<unsigned, std::map<unsigned, double>> Affinity;
+
+    std::vector<int> ExtendedColors;
+    std::map<unsigned, double> SpillWeight;
+
+    // Nodes live across a call (a regmask) in the current graph, and the
+    // callee-saved registers of the function with their subregisters.
+    std::map<unsigned, bool> CrossesCall;
+    BitVector CalleeSaved;
+
+    // Registers whose encoding needs a REX prefix (x86-64 only), the 64-bit
+    // general purpose registers, whose instructions carry REX.W, and the
+    // weighted instructions of each node that would need one on them. Filled
+    // by calculateEncodingCosts().
+    BitVector NeedsRex;
+    BitVector Rex64;
+    std::map<unsigned, double> RexCost;
+
+    // Virtual registers in select order: simplify() pushes them and
+    // biasedSelectExtended() colors them from the back.
+    std::vector<unsigned> SelectStack;
+
+    // Position of each physical register in the color list given to
+    // pickFreeColor(), -1 outside of it. Sized once per function.
+    std::vector<int> ColorSlot;
+
+    // Scratch list of the preferred colors of a node, see getPreferredRegs().
+    std::vector<int> PreferredRegs;
+
+    // Scratch affinity of each position of the color list in pickFreeColor().
+    std::vector<double> AffinityScore;
+
+    // Allocation cache (-color-cache-dir): decisions recorded for the current
+    // function, and the cached ones being replayed instead of coloring.
+    std::vector<AllocationCache::Decision> Recorded;
+    std::vector<AllocationCache::Decision> Replay;
+    unsigned ReplayPos;
+    bool Replaying;
+    bool Cacheable;
+
+    // Number of times each virtual register was evicted and requeued.
+    std::map<unsigned, unsigned> EvictCount;
+
+    // Interferences per register unit, for the virtual register of the current
+    // selectOrSplit() call. Aliasing candidates share units, so each unit is
+    // queried once; cleared before the matrix changes.
+    DenseMap<unsigned, UnitInterference> UnitInterferences;
+
+    // Whether the current function was colored by sweepColor().
+    bool Swept;
+
+    // ===-------------- Strategy hooks --------------===
+
+    /// Name of the strategy, as registered with RegisterRegAlloc.
+    virtual StringRef getStrategyName() const = 0;
+
+    /// Run the coloring of the current function. The default builds the graph,
+    /// computes the spill costs, simplifies and selects once.
+    virtual void algorithm(MachineFunction &mf);
+
+    /// Fill SelectStack with every node of the interference graph.
+    virtual void simplify() = 0;
+
+    /// Pick a color from Colors for vreg, or COLOR_INVALID when every color
+    /// is taken by a neighbor.
+    virtual int getColor(const std::vector<int> &Colors, unsigned vreg) = 0;
+
+    /// Physical registers vreg may be colored with.
+    virtual std::vector<int> getPotentialRegs(unsigned vreg);
+
+    /// Physical registers tried, in order, when VirtReg is assigned.
+    virtual std::vector<int> getAssignmentOrder(LiveInterval &VirtReg);
+
+    // ===-------------- Shared kernels --------------===
+
+    void calculateSpillCosts();
+
+    /// Fill RexCost for the nodes of the graph, under -color-size-pref.
+    void calculateEncodingCosts();
+
+    /// Weight of an instruction of MBB in the copy and encoding costs.
+    double getInstrWeight(const MachineBasicBlock &MBB);
+
+    void clear();
+
+    void clearAll();
+
+    /// Interferences of VirtReg on Unit, from UnitInterferences.
+    const UnitInterference &queryUnit(LiveInterval &VirtReg, unsigned Unit);
+
+    /// Collect the interferences of VirtReg on PhysReg into Intfs and their
+    /// cost. Return false if one of them is unspillable.
+    bool getEvictionCost(LiveInterval &VirtReg, unsigned PhysReg, EvictionCost &Cost,
+                         SmallVectorImpl<LiveInterval*> &Intfs);
+
+    /// Evict the interferences of the candidate of PhysRegCands that costs the
+    /// least, if they weigh less than VirtReg together, and return it, or 0.
+    unsigned tryEvict(LiveInterval &VirtReg, ArrayRef<unsigned> PhysRegCands,
+                      SmallVectorImpl<unsigned> &SplitVRegs);
+
+    /// Unassign Intfs and requeue them, or spill the ones evicted more than
+    /// -color-evict-cascade times.
+    void evictInterferences(ArrayRef<LiveInterval*> Intfs, SmallVectorImpl<unsigned> &SplitVRegs);
+
+    bool isMarkedForSpill(unsigned vreg);
+
+    void printVirtualRegisters();
+
+    // ===-------------- Allocation cache --------------===
+
+    void record(unsigned VirtReg, uint32_t Kind, unsigned PhysReg);
+
+    bool replayDecision(LiveInterval &VirtReg, SmallVectorImpl<unsigned> &SplitVRegs, unsigned &PhysReg);
+
+    // ===-------------- Interference Graph methods --------------===
+
+    void buildInterferenceGraph();
+
+    /// Fill CopyRelated and CopyFrequency from the copies of the function.
+    void buildCopyRelated();
+
+    /// Fill Affinity from the copies and the tied operands of the function.
+    void buildAffinities();
+
+    void printInterferenceGraph();
+
+    void printInterferenceGraphWithColor();
+
+    // ===-------------- Coloring methods --------------===
+
+    void biasedSelectExtended();
+
+    /// Color the function by a sweep over the live intervals, without the
+    /// graph, if every interval is a single segment and has a register free
+    /// of fixed interference. Return false otherwise.
+    bool sweepColor();
+
+    /// Recolor a graph of up to -color-exact-nodes nodes with the coloring of
+    /// least spill cost, if it is cheaper than the one biasedSelectExtended()
+    /// found and the search ends within -color-exact-time.
+    void exactSelect();
+
+    bool isExtendedColor(int color);
+
+    int createNewExtendedColor();
+
+    /// Select priority of vreg under -color-select-order, higher is colored
+    /// first. Ties are broken by degree.
+    double getSelectPriority(unsigned vreg);
+
+    /// Reads and writes of vreg weighted by the frequency of their block,
+    /// relative to the entry block: what spilling it costs at run time.
+    double getFrequencyWeightedCost(unsigned vreg);
+
+    const std::vector<int> &getPreferredRegs(unsigned vreg, const std::vector<int> &potentialRegs);
+
+    /// Select kernel: mark the colors of Colors taken by the neighbors of vreg
+    /// and return the free one at the position Choose(NumFree) picks among
+    /// them, or COLOR_INVALID when none is free. If vreg has partners in
+    /// Affinity or a RexCost, Choose picks among the free colors of highest
+    /// affinity less REX cost instead.
+    int pickFreeColor(const std::vector<int> &Colors, unsigned vreg,
+                      function_ref<unsigned(unsigned)> Choose);
+
+    template <class ColorSetT>
+    int pickFreeColorIn(const std::vector<int> &Colors, unsigned vreg,
+                        function_ref<unsigned(unsigned)> Choose);
+
+    // ===-------------- Spliting --------------===
+
+    void trySplitAll();
+
+    unsigned trySplit(LiveInterval &VirtReg, AllocationOrder &Order, SmallVectorImpl<unsigned> &NewVRegs);
+
+  public:
+    RAColorBasedCoalescing();
+
+    /// Return the pass name.
+    StringRef getPassName() const override { return "Color-based Coalescing Register Allocator"; }
+
+    /// RAColorBasedCoalescing analysis usage.
+    void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+    void releaseMemory() override;
+
+    Spiller &spiller() override { return *SpillerInstance; }
+
+    void enqueue(LiveInterval *LI) override {
+      Queue.push(LI);
+    }
+
+    LiveInterval *dequeue() override {
+      if (Queue.empty())
+        return nullptr;
+      LiveInterval *LI = Queue.top();
+      Queue.pop();
+      return LI;
+    }
+
+    unsigned selectOrSplit(LiveInterval &VirtReg, SmallVectorImpl<unsigned> &SplitVRegs) override;
+
+    /// Perform register allocation.
+    bool runOnMachineFunction(MachineFunction &mf) override;
+
+    MachineFunctionProperties getRequiredProperties() const override {
+      return MachineFunctionProperties().set(
+          MachineFunctionProperties::Property::NoPHIs);
+    }
+
+    static char ID;
+};
+
+FunctionPass *createColorBasedOursRegAlloc();
+FunctionPass *createColorBasedOidaraRegAlloc();
+FunctionPass *createColorBasedPBQPRegAlloc();
+
+} // end namespace llvm
+
+#endif
@@ -0,0 +1,138 @@
+//===-- RAColorBasedOidara.cpp - Color-based Coalescing, spill-cost variant ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the colorBased-oidara register allocator: nodes are
+// simplified by the lowest spill cost / degree ratio, each one takes the free
+// color of its copy partners or the first one, and nodes left with an extended
+// color are marked for spilling and the graph is colored again, for up to 10
+// rounds.
+//
+//===----------------------------------------------------------------------===//
+
+#include "RAColorBasedCoalescing.h"
+#include "llvm/CodeGen/RegAllocRegistry.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "regalloc"
+
+static RegisterRegAlloc colorBasedOidaraRegAlloc("colorBased-oidara",
+                                                 "color-based coalescing register allocator (spill cost order, first color)",
+                                                 createColorBasedOidaraRegAlloc);
+
+namespace {
+
+  class RAColorBasedOidara : public RAColorBasedCoalescing {
+    protected:
+      StringRef getStrategyName() const override { return "colorBased-oidara"; }
+
+      void algorithm(MachineFunction &mf) override;
+
+      void simplify() override;
+
+      int getColor(const std::vector<int> &Colors, unsigned vreg) override;
+
+    private:
+      bool spillCode();
+
+      void save();
+  };
+
+} // end anonymous namespace
+
+void RAColorBasedOidara::algorithm(MachineFunction &mf) {
+  int round = 0;
+  bool spill = true;
+
+  while (spill && round < 10) {
+    round++;
+    //dbgs() << "Round #" << round << "\n\n";
+
+    buildInterferenceGraph();
+
+    calculateSpillCosts();
+
+    simplify();
+
+    biasedSelectExtended();
+
+    //printInterferenceGraphWithColor();
+
+    spill = spillCode();
+
+    if (!spill || round == 10) {
+      save();
+    }
+
+    clear();
+
+  }
+}
+
+bool RAColorBasedOidara::spillCode() {
+  bool spill = false;
+  for(std::map<unsigned, int> :: iterator i = ColorsTemp.begin(); i != ColorsTemp.end(); i++) {
+    unsigned vreg = i->first;
+    int color = i->second;
+
+    if (isExtendedColor(color)) {
+      Colors[vreg] = color;
+      spill = true;
+    }
+  }
+
+  return spill;
+}
+
+void RAColorBasedOidara::save() {
+  for(std::map<unsigned, int> :: iterator i = ColorsTemp.begin(); i != ColorsTemp.end(); i++) {
+    unsigned vreg = i->first;
+    int color = i->second;
+
+    Colors[vreg] = color;
+  }
+}
+
+void RAColorBasedOidara::simplify() {
+  // picking, until the graph is empty, the node with the lowest spill cost
+  // over degree
+  while (true) {
+    unsigned min = 0;
+    for(std::map<unsigned, std::set<unsigned>> :: iterator i = InterferenceGraph.begin(); i != InterferenceGraph.end(); i++) {
+      unsigned vreg = i->first;
+      if(!OnStack[vreg] && (min == 0 || (SpillWeight[vreg]/Degree[vreg] < SpillWeight[min]/Degree[min]))) {
+        min = i->first;
+      }
+    }
+
+    //graph empty
+    if(min == 0) {
+      return;
+    }
+
+    OnStack[min] = true;
+    SelectStack.push_back(min);
+
+    //decreasing the degree of the edges of min
+    for(std::map<unsigned, std::set<unsigned>> :: iterator j = InterferenceGraph.begin(); j != InterferenceGraph.end(); j++) {
+      if(j->second.count(min)) {
+        Degree[j->first]--;
+      }
+    }
+  }
+}
+
+int RAColorBasedOidara::getColor(const std::vector<int> &Colors, unsigned vreg) {
+  // the first color not taken by a neighbor
+  return pickFreeColor(Colors, vreg, [](unsigned) { return 0u; });
+}
+
+FunctionPass *llvm::createColorBasedOidaraRegAlloc() {
+  return new RAColorBasedOidara();
+}
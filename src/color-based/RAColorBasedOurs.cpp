@@ -0,0 +1,97 @@
+//===-- RAColorBasedOurs.cpp - Color-based Coalescing, degree-ordered variant ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the colorBased-ours register allocator: nodes are selected
+// by decreasing degree, each one takes the free color of its copy partners or
+// a random one, and the assignment tries the chosen color first.
+//
+//===----------------------------------------------------------------------===//
+
+#include "RAColorBasedCoalescing.h"
+#include "llvm/CodeGen/RegAllocRegistry.h"
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <tuple>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "regalloc"
+
+static RegisterRegAlloc colorBasedOursRegAlloc("colorBased-ours",
+                                               "color-based coalescing register allocator (degree order, random color)",
+                                               createColorBasedOursRegAlloc);
+
+namespace {
+
+  class RAColorBasedOurs : public RAColorBasedCoalescing {
+    protected:
+      StringRef getStrategyName() const override { return "colorBased-ours"; }
+
+      void algorithm(MachineFunction &mf) override;
+
+      void simplify() override;
+
+      int getColor(const std::vector<int> &Colors, unsigned vreg) override;
+
+      std::vector<int> getPotentialRegs(unsigned vreg) override;
+
+      std::vector<int> getAssignmentOrder(LiveInterval &VirtReg) override;
+  };
+
+} // end anonymous namespace
+
+void RAColorBasedOurs::algorithm(MachineFunction &mf) {
+  srand(time(NULL));
+
+  RAColorBasedCoalescing::algorithm(mf);
+}
+
+void RAColorBasedOurs::simplify() {
+  // sorting virtual registers by their priority (-color-select-order), then by
+  // their degree, the highest is selected first
+  std::vector<std::tuple<double, unsigned, unsigned>> Order;
+  for(std::map<unsigned, std::set<unsigned>> :: iterator i = InterferenceGraph.begin(); i != InterferenceGraph.end(); i++) {
+    unsigned vreg = i->first;
+    Order.push_back(std::make_tuple(getSelectPriority(vreg), Degree[vreg], vreg));
+  }
+
+  std::sort(Order.begin(), Order.end());
+  for (const std::tuple<double, unsigned, unsigned> &P : Order)
+    SelectStack.push_back(std::get<2>(P));
+}
+
+std::vector<int> RAColorBasedOurs::getPotentialRegs(unsigned vreg) {
+  std::vector<int> potentialRegs = RAColorBasedCoalescing::getPotentialRegs(vreg);
+
+  sort(potentialRegs.begin(), potentialRegs.end());
+  return potentialRegs;
+}
+
+std::vector<int> RAColorBasedOurs::getAssignmentOrder(LiveInterval &VirtReg) {
+  std::vector<int> potentialRegs = getPotentialRegs(VirtReg.reg);
+
+  // idx represents the index of ColorsTemp[VirtReg.reg])
+  int idx = std::lower_bound(potentialRegs.begin(), potentialRegs.end(), ColorsTemp[VirtReg.reg]) - potentialRegs.begin();
+  // rotating in order to put the color(physical register) chosen in getColor method as first member
+  std::rotate(potentialRegs.begin(), potentialRegs.begin() + idx, potentialRegs.end());
+
+  return potentialRegs;
+}
+
+int RAColorBasedOurs::getColor(const std::vector<int> &Colors, unsigned vreg) {
+  // selecting a random color among the ones not taken by a neighbor
+  return pickFreeColor(Colors, vreg, [](unsigned possibilities) {
+    return unsigned(rand()) % possibilities;
+  });
+}
+
+FunctionPass *llvm::createColorBasedOursRegAlloc() {
+  return new RAColorBasedOurs();
+}
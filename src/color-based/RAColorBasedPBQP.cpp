@@ -0,0 +1,209 @@
+//===-- RAColorBasedPBQP.cpp - Color-based Coalescing, cost-matrix variant ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the colorBased-pbqp register allocator: instead of a
+// select order, every node of the interference graph gets a cost per option
+// (spilled or one of its registers) and every pair of interfering or copy
+// related nodes a cost per pair of options, and PBQPSolver picks the options.
+// The costs are block-frequency weighted, in accesses at entry frequency (the
+// copies and REX prefixes count once in functions optimized for size):
+//   spilled                  the reads and writes of the node
+//   caller-saved, crossing   a save and a restore around each call crossed
+//   callee-saved, call-free  a save and a restore in the prologue
+//   not the copied register  the copies to and from physical registers
+//   needs a REX prefix       a third of a copy per instruction (x86-64)
+//   interfering nodes        infinite on overlapping registers
+//   copy related nodes       the copies between them, unless on one register
+// The chosen register is tried first during assignment.
+//
+//===----------------------------------------------------------------------===//
+
+#include "RAColorBasedCoalescing.h"
+#include "PBQPSolver.h"
+#include "llvm/CodeGen/RegAllocRegistry.h"
+#include <algorithm>
+#include <limits>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "regalloc"
+
+static RegisterRegAlloc colorBasedPBQPRegAlloc("colorBased-pbqp",
+                                               "color-based coalescing register allocator (cost matrices, PBQP reductions)",
+                                               createColorBasedPBQPRegAlloc);
+
+namespace {
+
+  class RAColorBasedPBQP : public RAColorBasedCoalescing {
+    protected:
+      StringRef getStrategyName() const override { return "colorBased-pbqp"; }
+
+      void algorithm(MachineFunction &mf) override;
+
+      void simplify() override;
+
+      int getColor(const std::vector<int> &Colors, unsigned vreg) override;
+
+      std::vector<int> getAssignmentOrder(LiveInterval &VirtReg) override;
+
+    private:
+      double getCallCrossingCost(unsigned vreg);
+
+      void solve();
+  };
+
+} // end anonymous namespace
+
+void RAColorBasedPBQP::algorithm(MachineFunction &mf) {
+  buildInterferenceGraph();
+
+  calculateSpillCosts();
+
+  buildCopyRelated();
+
+  calculateEncodingCosts();
+
+  solve();
+}
+
+void RAColorBasedPBQP::simplify() {
+  // nothing to do, algorithm() never selects: the solver orders the nodes
+}
+
+int RAColorBasedPBQP::getColor(const std::vector<int> &Colors, unsigned vreg) {
+  // the first color not taken by a neighbor
+  return pickFreeColor(Colors, vreg, [](unsigned) { return 0u; });
+}
+
+std::vector<int> RAColorBasedPBQP::getAssignmentOrder(LiveInterval &VirtReg) {
+  std::vector<int> potentialRegs = getPotentialRegs(VirtReg.reg);
+
+  // the register chosen by the solver first, then the allocation order
+  std::vector<int>::iterator chosen = std::find(potentialRegs.begin(), potentialRegs.end(), ColorsTemp[VirtReg.reg]);
+  if (chosen != potentialRegs.end())
+    std::rotate(potentialRegs.begin(), chosen, chosen + 1);
+
+  return potentialRegs;
+}
+
+// A save and a restore around every call the node is live across.
+double RAColorBasedPBQP::getCallCrossingCost(unsigned vreg) {
+  LiveInterval &LI = LIS->getInterval(vreg);
+  double cost = 0;
+  for (SlotIndex Slot : LIS->getRegMaskSlots()) {
+    // live before and after the call, not only an argument or a result
+    if (LI.liveAt(Slot.getBaseIndex()) && LI.liveAt(Slot.getDeadSlot()))
+      cost += 2 * MBFI->getBlockFreqRelativeToEntryBlock(LIS->getMBBFromIndex(Slot));
+  }
+  return cost;
+}
+
+void RAColorBasedPBQP::solve() {
+  const double inf = std::numeric_limits<double>::infinity();
+
+  // option 0 is the spill, option i the register i - 1 of the node
+  std::map<unsigned, unsigned> Node;
+  std::map<unsigned, std::vector<int>> Options;
+  PBQPSolver Solver;
+
+  // copies between a node and a physical register, by node
+  std::map<unsigned, std::vector<std::pair<unsigned, double>>> PhysCopies;
+  for (const std::pair<const std::pair<unsigned, unsigned>, double> &copy : CopyFrequency)
+    if (TargetRegisterInfo::isPhysicalRegister(copy.first.first))
+      PhysCopies[copy.first.second].push_back(std::make_pair(copy.first.first, copy.second));
+
+  for(std::map<unsigned, std::set<unsigned>> :: iterator i = InterferenceGraph.begin(); i != InterferenceGraph.end(); i++) {
+    unsigned vreg = i->first;
+    std::vector<int> &regs = Options[vreg] = getPotentialRegs(vreg);
+
+    double callCost = CrossesCall[vreg] ? getCallCrossingCost(vreg) : 0;
+    PBQPSolver::Vector Costs(regs.size() + 1, 0);
+    Costs[0] = getFrequencyWeightedCost(vreg);
+    for (unsigned r = 0, e = regs.size(); r != e; ++r) {
+      if (!EnableCallPreference)
+        continue;
+      if (CrossesCall[vreg] && !CalleeSaved.test(regs[r]))
+        Costs[r + 1] += callCost;
+      else if (!CrossesCall[vreg] && CalleeSaved.test(regs[r]))
+        Costs[r + 1] += 2;
+    }
+
+    std::map<unsigned, double>::const_iterator rex = RexCost.find(vreg);
+    if (rex != RexCost.end())
+      for (unsigned r = 0, e = regs.size(); r != e; ++r)
+        if (NeedsRex.test(regs[r]))
+          Costs[r + 1] += rex->second / 3;
+
+    // every option but the copied register keeps the copy
+    for (const std::pair<unsigned, double> &copy : PhysCopies[vreg])
+      for (unsigned o = 0, e = Costs.size(); o != e; ++o)
+        if (o == 0 || regs[o - 1] != int(copy.first))
+          Costs[o] += copy.second;
+
+    Node[vreg] = Solver.addNode(std::move(Costs));
+  }
+
+  for(std::map<unsigned, std::set<unsigned>> :: iterator i = InterferenceGraph.begin(); i != InterferenceGraph.end(); i++) {
+    unsigned vreg = i->first;
+    const std::vector<int> &regs = Options[vreg];
+
+    for (unsigned neighbor : i->second) {
+      // each edge once
+      if (neighbor < vreg)
+        continue;
+
+      const std::vector<int> &neighborRegs = Options[neighbor];
+      PBQPSolver::Matrix M(regs.size() + 1, neighborRegs.size() + 1);
+      for (unsigned r = 0, e = regs.size(); r != e; ++r)
+        for (unsigned n = 0, ne = neighborRegs.size(); n != ne; ++n)
+          if (TRI->regsOverlap(regs[r], neighborRegs[n]))
+            M.at(r + 1, n + 1) = inf;
+      Solver.addEdgeCosts(Node[vreg], Node[neighbor], M);
+    }
+  }
+
+  for (const std::pair<const std::pair<unsigned, unsigned>, double> &copy : CopyFrequency) {
+    unsigned first = copy.first.first, second = copy.first.second;
+    double freq = copy.second;
+    if (TargetRegisterInfo::isPhysicalRegister(first))
+      continue;
+
+    // the copy goes away only if both nodes get the same register
+    const std::vector<int> &firstRegs = Options[first], &secondRegs = Options[second];
+    PBQPSolver::Matrix M(firstRegs.size() + 1, secondRegs.size() + 1, freq);
+    for (unsigned r = 0, e = firstRegs.size(); r != e; ++r)
+      for (unsigned n = 0, ne = secondRegs.size(); n != ne; ++n)
+        if (firstRegs[r] == secondRegs[n])
+          M.at(r + 1, n + 1) = 0;
+    Solver.addEdgeCosts(Node[first], Node[second], M);
+  }
+
+  Solver.solve();
+
+  for (std::map<unsigned, unsigned>::iterator i = Node.begin(); i != Node.end(); i++) {
+    unsigned option = Solver.getSelection(i->second);
+    ColorsTemp[i->first] = option ? Options[i->first][option - 1] : COLOR_INVALID;
+  }
+
+  // spilled nodes take extended colors, as in biasedSelectExtended()
+  for (std::map<unsigned, unsigned>::iterator i = Node.begin(); i != Node.end(); i++) {
+    unsigned vreg = i->first;
+    if (ColorsTemp[vreg] != COLOR_INVALID)
+      continue;
+
+    int color = getColor(ExtendedColors, vreg);
+    if (color == COLOR_INVALID)
+      color = createNewExtendedColor();
+    ColorsTemp[vreg] = color;
+  }
+}
+
+FunctionPass *llvm::createColorBasedPBQPRegAlloc() {
+  return new RAColorBasedPBQP();
+}
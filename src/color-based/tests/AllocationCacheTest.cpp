@@ -0,0 +1,72 @@
+//===-- AllocationCacheTest.cpp - Round trip of the allocation cache ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the MIT License.
+// See the LICENSE file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Inserts the records of two functions into the cache of a directory, then,
+// in a second process, looks both up from the file:
+//   AllocationCacheTest <dir> write
+//   AllocationCacheTest <dir> read
+// Exits with 1 and a message on the first record that does not match.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AllocationCache.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstring>
+#include <vector>
+
+using namespace llvm;
+
+static AllocationCache::Key makeKey(uint8_t Seed) {
+  AllocationCache::Key K;
+  for (unsigned i = 0; i != sizeof(K.Bytes); ++i)
+    K.Bytes[i] = Seed + i;
+  return K;
+}
+
+static std::vector<AllocationCache::Decision> makeDecisions(uint32_t VirtReg) {
+  std::vector<AllocationCache::Decision> D;
+  D.push_back({VirtReg, AllocationCache::Assign, 22});
+  D.push_back({VirtReg + 1, AllocationCache::Spill, 0});
+  D.push_back({VirtReg + 2, AllocationCache::Requeue, 23});
+  return D;
+}
+
+static bool check(AllocationCache &Cache, uint8_t Seed, uint32_t VirtReg) {
+  std::vector<AllocationCache::Decision> Expected = makeDecisions(VirtReg);
+  std::vector<AllocationCache::Decision> Found;
+  if (!Cache.lookup(makeKey(Seed), Found)) {
+    errs() << "record " << unsigned(Seed) << " not found\n";
+    return false;
+  }
+  if (Found.size() != Expected.size() ||
+      memcmp(Found.data(), Expected.data(),
+             Found.size() * sizeof(AllocationCache::Decision))) {
+    errs() << "record " << unsigned(Seed) << " differs\n";
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    errs() << "usage: " << argv[0] << " <dir> write|read\n";
+    return 2;
+  }
+  AllocationCache &Cache = AllocationCache::get(argv[1]);
+
+  if (!strcmp(argv[2], "write")) {
+    Cache.insert(makeKey(1), makeDecisions(1024));
+    Cache.insert(makeKey(100), makeDecisions(2048));
+  }
+
+  if (!check(Cache, 1, 1024) || !check(Cache, 100, 2048))
+    return 1;
+  outs() << "both records found\n";
+  return 0;
+}